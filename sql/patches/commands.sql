@@ -98,6 +98,10 @@ INSERT INTO command (name, security, help) VALUES
 ("debug time", 5, "Syntax: .debug time [$multiplicator]\r\nMultiply server time by a factor."),
 ("debug moveflags", 5, "Syntax: .debug moveflags [$moveFlagsAsHEX]\r\nDisplay or change target moveflags"),
 ("debug movespline", 5, "Syntax: .debug movespline\r\nDisplay debug about target current movement"),
+("debug vmapbench", 5, "Syntax: .debug vmapbench [$queries [$batchSize [$radius]]]\r\n\r\nTimes $queries (2000) vmap height and LoS queries to random points within $radius (30) yards, one call per point then batches of $batchSize (32), and counts the results that differ."),
+("debug procbench", 5, "Syntax: .debug procbench [$hits]\r\n\r\nRuns $hits (100000) melee hits, done and taken in turn, on the selected unit (or yourself) and compares the proc candidates lookup over all its aura holders with the proc flags index."),
+("debug eventbench", 5, "Syntax: .debug eventbench [$objects [$eventsPerObject]]\r\n\r\nRuns the same random periodic events, $eventsPerObject (8) for each of $objects (2000) objects, on EventProcessor and on a multimap based processor. Shows the time taken by each one and the tree nodes allocated by the multimap."),
+("debug cellbench", 5, "Syntax: .debug cellbench [$units [$searches [$radius]]]\r\n\r\nSummons $units (500) units in your cell, then times $searches (10000) unit searches within $radius (10) yards of you on the grid containers and on the cell position caches. The units are removed afterwards."),
 ("debug dump", 4, "Syntax: .debug dump\r\nDump packets send to the server by targeted player to a file."),
 ("debug movemotion", 5, "Syntax: .debug movemotion $moveType\r\nChange target motion generator to idle (0), random (1), confused (2), or fleeing (3)"),
 ("debug factionchange_items", 5, "Attempt to find items not handled by faction change tables."),
@@ -261,6 +265,7 @@ INSERT INTO command (name, security, help) VALUES
 ("pet delete", 4, "Syntax: .pet delete $petId\r\n\r\nPermanently removes pet id. May not work if the player is online."),
 ("pbcast stats", 5, "Syntax: .bcast stats\r\n\r\nDisplays statistics about running packet broadcast threads."),
 ("pbcast setthreads", 5, "Syntax: .bcast setthreads $num_threads\r\n\r\nChanges number of threads for packet broadcasting."),
+("perf", 5, "Syntax: .perf [$mapid [$instanceid]]\r\n\r\nShows the update latency percentiles of each phase and the counters of the current (or given) map, since the last profile dump."),
 ("pool list", 5, "Syntax: .pool list\r\n\r\nList of pools with spawn in current map (only work in instances. Non-instanceable maps share pool system state os useless attempt get all pols at all continents."),
 ("pool update", 5, "Syntax: .pool update $pool_id\r\n\r\nUpdates given $pool_id in current map (possibly adds a new spawn)"),
 ("pool spawns", 5, "Syntax: .pool spawns $pool_id\r\n\r\nList current creatures/objects listed in pools (or in specific $pool_id) and spawned (added to grid data, not meaning show in world."),
@@ -96,6 +96,13 @@ class MANGOS_DLL_DECL Grid
             return m_activeGridObjects.size() + i_objects.template Count<ACTIVE_OBJECT>();
         }
 
+        /** Returns the number of objects of any type within the grid.
+         */
+        uint32 ObjectsInGrid() const
+        {
+            return i_container.CountAll() + i_objects.CountAll();
+        }
+
         /** Inserts a container type object into the grid.
          */
         template<class SPECIFIC_OBJECT>
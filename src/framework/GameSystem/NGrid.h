@@ -167,6 +167,13 @@ class MANGOS_DLL_DECL NGrid
             return count;
         }
 
+        uint32 ObjectsInCell(const uint32 x, const uint32 y) const
+        {
+            assert(x < N);
+            assert(y < N);
+            return i_cells[x][y].ObjectsInGrid();
+        }
+
         template<class SPECIFIC_OBJECT>
         bool AddGridObject(const uint32 x, const uint32 y, SPECIFIC_OBJECT *obj)
         {
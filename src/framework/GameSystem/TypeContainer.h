@@ -214,6 +214,8 @@ class MANGOS_DLL_DECL TypeMapContainer
         template<class SPECIFIC_TYPE>
         size_t Count() const { return MaNGOS::Count(i_elements, (SPECIFIC_TYPE*)NULL); }
 
+        size_t CountAll() const { return MaNGOS::CountAll(i_elements); }
+
         /// inserts a specific object into the container
         template<class SPECIFIC_TYPE>
         bool insert(SPECIFIC_TYPE *obj)
@@ -64,6 +64,24 @@ namespace MaNGOS
         return Count(elements._TailElements, fake);
     }
 
+    // count of all the objects, whatever their type
+    template<class SPECIFIC_TYPE>
+    size_t CountAll(const ContainerMapList<SPECIFIC_TYPE> &elements)
+    {
+        return elements._element.getSize();
+    }
+
+    inline size_t CountAll(const ContainerMapList<TypeNull> &/*elements*/)
+    {
+        return 0;
+    }
+
+    template<class H, class T>
+    size_t CountAll(const ContainerMapList<TypeList<H, T> >&elements)
+    {
+        return CountAll(elements._elements) + CountAll(elements._TailElements);
+    }
+
     // non-const insert functions
     template<class SPECIFIC_TYPE>
     SPECIFIC_TYPE* Insert(ContainerMapList<SPECIFIC_TYPE> &elements, SPECIFIC_TYPE *obj)
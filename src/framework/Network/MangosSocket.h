@@ -11,8 +11,8 @@
 #include <ace/Connector.h>
 #include <ace/Thread_Mutex.h>
 #include <ace/Guard_T.h>
-#include <ace/Unbounded_Queue.h>
 #include <ace/Message_Block.h>
+#include <ace/os_include/sys/os_uio.h>
 
 #if !defined (ACE_LACKS_PRAGMA_ONCE)
 #pragma once
@@ -20,6 +20,10 @@
 
 #include "Common.h"
 
+#include <atomic>
+#include <deque>
+#include <memory>
+
 class ACE_Message_Block;
 class WorldPacket;
 class WorldSession;
@@ -49,6 +53,15 @@ struct ClientPktHeader
 #pragma pack(pop)
 #endif
 
+/// Write syscalls done by the sockets of a network thread, against the packets they carried
+struct SocketSendStats
+{
+    SocketSendStats() : sendCalls(0), packets(0) {}
+
+    std::atomic<uint64> sendCalls;
+    std::atomic<uint64> packets;
+};
+
 /// Handler that can communicate over stream sockets.
 typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
 
@@ -64,12 +77,20 @@ typedef ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_NULL_SYNCH> WorldHandler;
  * a queue where it stores packet if there is no place on
  * the queue. The reason this is done, is because the server
  * does really a lot of small-size writes to it, and it doesn't
- * scale well to allocate memory for every. When something is
+ * scale well to allocate memory for every. Queued packets are
+ * reference counted and written directly from their storage
+ * with scatter/gather I/O (the buffer first, then the queue),
+ * so a packet shared by many sockets is never copied per socket.
+ * Headers of queued packets are built and encrypted in place,
+ * in queue order, right before being written. When something is
  * written to the output buffer the socket is not immediately
  * activated for output (again for the same reason), there
  * is 10ms celling (thats why there is Update() method).
  * This concept is similar to TCP_CORK, but TCP_CORK
- * uses 200ms celling. As result overhead generated by
+ * uses 200ms celling. With a cork delay (Network.CorkDelay),
+ * Update() holds the output until the delay has passed since the
+ * first pending packet, or until CORK_FLUSH_BYTES are pending, so
+ * the packets of several ticks leave in one write. As result overhead generated by
  * sending packets from "producer" threads is minimal,
  * and doing a lot of writes with small size is tolerated.
  *
@@ -104,8 +125,32 @@ class MangosSocket : protected WorldHandler
         typedef ACE_Thread_Mutex LockType;
         typedef ACE_Guard<LockType> GuardType;
 
+        /// Biggest header of the sockets using this class
+        static const size_t MAX_HEADER_SIZE = sizeof(ClientPktHeader);
+
+        /// Shared packets up to this size are copied in the output buffer rather than referenced
+        static const size_t MAX_COPIED_SHARED_PACKET_SIZE = 512;
+
+        /// A corked socket is flushed as soon as that much output is pending
+        static const size_t CORK_FLUSH_BYTES = 16 * 1024;
+
+        /// A packet waiting in the queue
+        struct OutPacket
+        {
+            OutPacket() : prepare(NULL), headerSize(0), sent(0) {}
+
+            std::shared_ptr<WorldPacket const> packet;
+            /// Set while the packet, owned by this socket only, still has to go through PrepareQueuedPacket
+            WorldPacket* prepare;
+            /// Encrypted header, built when the packet is about to be written
+            uint8 header[MAX_HEADER_SIZE];
+            size_t headerSize;
+            /// Bytes of header + payload already sent
+            size_t sent;
+        };
+
         /// Queue for storing packets for which there is no space.
-        typedef ACE_Unbounded_Queue<WorldPacket*> PacketQueueT;
+        typedef std::deque<OutPacket> PacketQueueT;
 
         /// Check if socket is closed.
         bool IsClosed() const { return closing_; }
@@ -121,6 +166,15 @@ class MangosSocket : protected WorldHandler
         /// @return -1 of failure
         int SendPacket (const WorldPacket& pct);
 
+        /// Same, for a packet sent to several sockets: big packets are queued without any copy.
+        int SendPacket (std::shared_ptr<WorldPacket const> const& pct);
+
+        /// Bytes waiting in userspace: output buffer and payload of the queued packets
+        size_t GetQueuedBytes() const { return m_QueuedBytes; }
+        /// Highest GetQueuedBytes() value seen
+        size_t GetMaxQueuedBytes() const { return m_MaxQueuedBytes; }
+        size_t GetQueuedPacketsCount() const { return m_QueuedPacketsCount; }
+
         /// Add reference to this object.
         long AddReference() { return static_cast<long>(add_reference()); }
 
@@ -142,6 +196,13 @@ class MangosSocket : protected WorldHandler
         /// @param new_pct received packet ,note that you need to delete it.
         int ProcessIncoming (WorldPacket* new_pct) { delete new_pct; return 0; }
         int OnSocketOpen() { return 0; }
+        /// Last changes to a queued packet before it is written, in the network thread.
+        /// Only called for packets flagged IsCompressionPending.
+        /// @return false if the packet has to be dropped
+        bool PrepareQueuedPacket(WorldPacket& /*pct*/) { return true; }
+        /// Writes the clear header of 'pct' in 'buffer' (at most MAX_HEADER_SIZE bytes)
+        /// @return size of the header
+        size_t BuildHeader(const WorldPacket& pct, uint8* buffer);
 
         /// Called on open ,the void* is the acceptor.
         virtual int open (void *);
@@ -176,11 +237,25 @@ class MangosSocket : protected WorldHandler
         /// Need to be called with m_OutBufferLock lock held
         int iSendPacket (const WorldPacket& pct);
 
-        /// Flush m_PacketQueue if there are packets in it
+        /// Add a packet at the end of m_PacketQueue
         /// Need to be called with m_OutBufferLock lock held
-        /// @return true if it wrote to the buffer ( AKA you need
-        /// to mark the socket for output ).
-        bool iFlushPacketQueue ();
+        void iQueuePacket (std::shared_ptr<WorldPacket const> const& pct, WorldPacket* prepare);
+
+        /// Fill 'iov' with the output buffer and the first queued packets, preparing them
+        /// and encrypting their headers as needed.
+        /// Need to be called with m_OutBufferLock lock held
+        /// @return number of iovec used, 'length' is set to the total size
+        int iBuildOutputVector (iovec* iov, int maxCount, size_t& length);
+
+        /// Drop 'length' sent bytes from the output buffer and the queue
+        /// Need to be called with m_OutBufferLock lock held
+        void iConsumeOutput (size_t length);
+
+        void iUpdateQueuedBytes ();
+
+        /// Account a packet accepted by SendPacket, starting the cork delay if it is the first pending one
+        /// Need to be called with m_OutBufferLock lock held
+        void iAddPendingPacket ();
 
         /// Time in which the last ping was received
         ACE_Time_Value m_LastPingTime;
@@ -224,9 +299,29 @@ class MangosSocket : protected WorldHandler
         /// this allows not-to kick player if its buffer is overflowed.
         PacketQueueT m_PacketQueue;
 
+        /// Payload bytes of m_PacketQueue not sent yet
+        size_t m_QueuedPayloadBytes;
+
+        /// Output metrics, readable from any thread
+        std::atomic<size_t> m_QueuedBytes;
+        std::atomic<size_t> m_MaxQueuedBytes;
+        std::atomic<size_t> m_QueuedPacketsCount;
+
         /// True if the socket is registered with the reactor for output
         bool m_OutActive;
 
+        /// Milliseconds the output may be held by Update(), 0 to write it on the next network tick
+        uint32 m_CorkDelay;
+
+        /// getMSTime() of the first packet pending since the last complete write
+        std::atomic<uint32> m_CorkStart;
+
+        /// Packets accepted by SendPacket and not fully written yet
+        uint32 m_PendingPackets;
+
+        /// Counters of the network thread handling this socket
+        SocketSendStats* m_SendStats;
+
         uint32 m_Seed;
 
         bool m_isServerSocket;
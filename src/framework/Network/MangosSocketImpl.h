@@ -21,6 +21,7 @@
 #include "Auth/Sha1.h"
 #include "WorldSession.h"
 #include "Log.h"
+#include "Timer.h"
 #include "DBCStores.h"
 
 
@@ -35,7 +36,15 @@ MangosSocket<SessionType, SocketName, Crypt>::MangosSocket() :
     m_Header(sizeof(ClientPktHeader)),
     m_OutBuffer(0),
     m_OutBufferSize(65536),
+    m_QueuedPayloadBytes(0),
+    m_QueuedBytes(0),
+    m_MaxQueuedBytes(0),
+    m_QueuedPacketsCount(0),
     m_OutActive(false),
+    m_CorkDelay(0),
+    m_CorkStart(0),
+    m_PendingPackets(0),
+    m_SendStats(NULL),
     m_Seed(static_cast<uint32>(rand32())),
     m_isServerSocket(true)
 {
@@ -53,10 +62,6 @@ MangosSocket<SessionType, SocketName, Crypt>::~MangosSocket(void)
     closing_ = true;
 
     peer().close();
-
-    WorldPacket* pct;
-    while (m_PacketQueue.dequeue_head(pct) == 0)
-        delete pct;
 }
 
 template <typename SessionType, typename SocketName, typename Crypt>
@@ -87,25 +92,58 @@ int MangosSocket<SessionType, SocketName, Crypt>::SendPacket(const WorldPacket&
     if (closing_)
         return -1;
 
-    if (((SocketName*)this)->iSendPacket(pct) == -1)
+    // Packets still needing some work (compression) are left to the network thread.
+    // Once a packet is queued, the next ones are queued as well to keep the order.
+    if (pct.IsCompressionPending() || !m_PacketQueue.empty() || iSendPacket(pct) == -1)
     {
-        WorldPacket* npct;
-
-        ACE_NEW_RETURN(npct, WorldPacket(pct), -1);
-
         // NOTE maybe check of the size of the queue can be good ?
         // to make it bounded instead of unbounded
-        if (m_PacketQueue.enqueue_tail(npct) == -1)
-        {
-            delete npct;
-            sLog.outError("MangosSocket<SessionType, SocketName, Crypt>::SendPacket: m_PacketQueue.enqueue_tail failed");
-            return -1;
-        }
+        std::shared_ptr<WorldPacket> npct = std::make_shared<WorldPacket>(pct);
+        iQueuePacket(npct, npct->IsCompressionPending() ? npct.get() : NULL);
     }
 
+    iAddPendingPacket();
+    iUpdateQueuedBytes();
+    return 0;
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+int MangosSocket<SessionType, SocketName, Crypt>::SendPacket(std::shared_ptr<WorldPacket const> const& pct)
+{
+    // Shared packets can not be modified, work on a private copy
+    if (pct->IsCompressionPending())
+        return SendPacket(*pct);
+
+    ACE_GUARD_RETURN(LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    if (!m_PacketQueue.empty() || pct->size() > MAX_COPIED_SHARED_PACKET_SIZE || iSendPacket(*pct) == -1)
+        iQueuePacket(pct, NULL);
+
+    iAddPendingPacket();
+    iUpdateQueuedBytes();
     return 0;
 }
 
+template <typename SessionType, typename SocketName, typename Crypt>
+void MangosSocket<SessionType, SocketName, Crypt>::iAddPendingPacket()
+{
+    if (!m_PendingPackets++ && m_CorkDelay)
+        m_CorkStart = WorldTimer::getMSTime();
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+void MangosSocket<SessionType, SocketName, Crypt>::iQueuePacket(std::shared_ptr<WorldPacket const> const& pct, WorldPacket* prepare)
+{
+    m_PacketQueue.push_back(OutPacket());
+    OutPacket& out = m_PacketQueue.back();
+    out.packet = pct;
+    out.prepare = prepare;
+    m_QueuedPayloadBytes += pct->size();
+}
+
 template <typename SessionType, typename SocketName, typename Crypt>
 int MangosSocket<SessionType, SocketName, Crypt>::open(void *a)
 {
@@ -210,15 +248,24 @@ int MangosSocket<SessionType, SocketName, Crypt>::handle_output(ACE_HANDLE)
     if (closing_)
         return -1;
 
-    const size_t send_len = m_OutBuffer->length();
+    iovec iov[64];
+    size_t send_len = 0;
+    const int iovcnt = iBuildOutputVector(iov, 64, send_len);
 
     if (send_len == 0)
+    {
+        iUpdateQueuedBytes();
         return cancel_wakeup_output(Guard);
+    }
 
 #ifdef MSG_NOSIGNAL
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len, MSG_NOSIGNAL);
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    ssize_t n = ::sendmsg(get_handle(), &msg, MSG_NOSIGNAL);
 #else
-    ssize_t n = peer().send(m_OutBuffer->rd_ptr(), send_len);
+    ssize_t n = peer().sendv(iov, iovcnt);
 #endif // MSG_NOSIGNAL
 
     if (n == 0)
@@ -230,26 +277,131 @@ int MangosSocket<SessionType, SocketName, Crypt>::handle_output(ACE_HANDLE)
 
         return -1;
     }
-    else if (n < (ssize_t)send_len) //now n > 0
-    {
-        m_OutBuffer->rd_ptr(static_cast<size_t>(n));
 
-        // move the data to the base of the buffer
-        m_OutBuffer->crunch();
+    iConsumeOutput(static_cast<size_t>(n));
+    iUpdateQueuedBytes();
+
+    const bool flushed = m_OutBuffer->length() == 0 && m_PacketQueue.empty();
+    if (m_SendStats)
+    {
+        m_SendStats->sendCalls.fetch_add(1, std::memory_order_relaxed);
+        if (flushed)
+            m_SendStats->packets.fetch_add(m_PendingPackets, std::memory_order_relaxed);
+    }
+    if (flushed)
+        m_PendingPackets = 0;
 
+    // Partial write, or more packets than iovecs: wait for the socket to be writable again
+    if (flushed)
+        return cancel_wakeup_output(Guard);
+    else
         return schedule_wakeup_output(Guard);
+}
+
+template <typename SessionType, typename SocketName, typename Crypt>
+int MangosSocket<SessionType, SocketName, Crypt>::iBuildOutputVector(iovec* iov, int maxCount, size_t& length)
+{
+    int count = 0;
+    length = 0;
+
+    if (m_OutBuffer->length())
+    {
+        iov[count].iov_base = m_OutBuffer->rd_ptr();
+        iov[count].iov_len = m_OutBuffer->length();
+        length += m_OutBuffer->length();
+        ++count;
     }
-    else //now n == send_len
+
+    typename PacketQueueT::iterator itr = m_PacketQueue.begin();
+    while (itr != m_PacketQueue.end() && count + 2 <= maxCount)
     {
-        m_OutBuffer->reset();
+        OutPacket& out = *itr;
+        if (!out.headerSize)
+        {
+            if (out.prepare)
+            {
+                m_QueuedPayloadBytes -= out.prepare->size();
+                if (!((SocketName*)this)->PrepareQueuedPacket(*out.prepare))
+                {
+                    itr = m_PacketQueue.erase(itr);
+                    continue;
+                }
+                m_QueuedPayloadBytes += out.prepare->size();
+                out.prepare = NULL;
+            }
+
+            // Headers are encrypted in the order packets are written
+            out.headerSize = ((SocketName*)this)->BuildHeader(*out.packet, out.header);
+            m_Crypt.EncryptSend(out.header, out.headerSize);
+        }
+
+        if (out.sent < out.headerSize)
+        {
+            iov[count].iov_base = reinterpret_cast<char*>(out.header + out.sent);
+            iov[count].iov_len = out.headerSize - out.sent;
+            length += out.headerSize - out.sent;
+            ++count;
+        }
+
+        size_t payloadSent = out.sent > out.headerSize ? out.sent - out.headerSize : 0;
+        if (out.packet->size() > payloadSent)
+        {
+            iov[count].iov_base = reinterpret_cast<char*>(const_cast<uint8*>(out.packet->contents()) + payloadSent);
+            iov[count].iov_len = out.packet->size() - payloadSent;
+            length += out.packet->size() - payloadSent;
+            ++count;
+        }
+        ++itr;
+    }
+
+    return count;
+}
 
-        if (!iFlushPacketQueue())
-            return cancel_wakeup_output(Guard);
+template <typename SessionType, typename SocketName, typename Crypt>
+void MangosSocket<SessionType, SocketName, Crypt>::iConsumeOutput(size_t length)
+{
+    if (const size_t buffered = m_OutBuffer->length())
+    {
+        if (length >= buffered)
+        {
+            m_OutBuffer->reset();
+            length -= buffered;
+        }
         else
-            return schedule_wakeup_output(Guard);
+        {
+            m_OutBuffer->rd_ptr(length);
+
+            // move the data to the base of the buffer
+            m_OutBuffer->crunch();
+            return;
+        }
+    }
+
+    while (length)
+    {
+        MANGOS_ASSERT(!m_PacketQueue.empty());
+        OutPacket& out = m_PacketQueue.front();
+        const size_t total = out.headerSize + out.packet->size();
+        if (length < total - out.sent)
+        {
+            out.sent += length;
+            return;
+        }
+
+        length -= total - out.sent;
+        m_QueuedPayloadBytes -= out.packet->size();
+        m_PacketQueue.pop_front();
     }
+}
 
-    ACE_NOTREACHED(return 0);
+template <typename SessionType, typename SocketName, typename Crypt>
+void MangosSocket<SessionType, SocketName, Crypt>::iUpdateQueuedBytes()
+{
+    const size_t queued = m_OutBuffer->length() + m_QueuedPayloadBytes;
+    m_QueuedBytes = queued;
+    m_QueuedPacketsCount = m_PacketQueue.size();
+    if (queued > m_MaxQueuedBytes)
+        m_MaxQueuedBytes = queued;
 }
 
 template <typename SessionType, typename SocketName, typename Crypt>
@@ -282,7 +434,11 @@ int MangosSocket<SessionType, SocketName, Crypt>::Update(void)
     if (closing_)
         return -1;
 
-    if (m_OutActive || m_OutBuffer->length() == 0)
+    if (m_OutActive || (m_OutBuffer->length() == 0 && m_PacketQueue.empty()))
+        return 0;
+
+    // Corked: let small writes pile up until the deadline
+    if (m_CorkDelay && m_QueuedBytes < CORK_FLUSH_BYTES && WorldTimer::getMSTimeDiffToNow(m_CorkStart) < m_CorkDelay)
         return 0;
 
     return handle_output(get_handle());
@@ -482,14 +638,8 @@ int MangosSocket<SessionType, SocketName, Crypt>::schedule_wakeup_output(GuardTy
 }
 
 template <typename SessionType, typename SocketName, typename Crypt>
-int MangosSocket<SessionType, SocketName, Crypt>::iSendPacket(const WorldPacket& pct)
+size_t MangosSocket<SessionType, SocketName, Crypt>::BuildHeader(const WorldPacket& pct, uint8* buffer)
 {
-    if (m_OutBuffer->space() < pct.size() + sizeof(ServerPktHeader))
-    {
-        errno = ENOBUFS;
-        return -1;
-    }
-
     ServerPktHeader header;
 
     header.cmd = pct.GetOpcode();
@@ -499,43 +649,30 @@ int MangosSocket<SessionType, SocketName, Crypt>::iSendPacket(const WorldPacket&
     EndianConvertReverse(header.size);
     EndianConvert(header.cmd);
 
-    m_Crypt.EncryptSend((uint8*) & header, sizeof(header));
-
-    if (m_OutBuffer->copy((char*) & header, sizeof(header)) == -1)
-        ACE_ASSERT(false);
-
-    if (!pct.empty())
-        if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
-            ACE_ASSERT(false);
-
-    return 0;
+    memcpy(buffer, &header, sizeof(header));
+    return sizeof(header);
 }
 
 template <typename SessionType, typename SocketName, typename Crypt>
-bool MangosSocket<SessionType, SocketName, Crypt>::iFlushPacketQueue()
+int MangosSocket<SessionType, SocketName, Crypt>::iSendPacket(const WorldPacket& pct)
 {
-    WorldPacket *pct;
-    bool haveone = false;
+    uint8 header[MAX_HEADER_SIZE];
+    const size_t headerSize = ((SocketName*)this)->BuildHeader(pct, header);
 
-    while (m_PacketQueue.dequeue_head(pct) == 0)
+    if (m_OutBuffer->space() < pct.size() + headerSize)
     {
-        if (((SocketName*)this)->iSendPacket(*pct) == -1)
-        {
-            if (m_PacketQueue.enqueue_head(pct) == -1)
-            {
-                delete pct;
-                sLog.outError("MangosSocket<SessionType, SocketName, Crypt>::iFlushPacketQueue m_PacketQueue->enqueue_head");
-                return false;
-            }
-
-            break;
-        }
-        else
-        {
-            haveone = true;
-            delete pct;
-        }
+        errno = ENOBUFS;
+        return -1;
     }
 
-    return haveone;
+    m_Crypt.EncryptSend(header, headerSize);
+
+    if (m_OutBuffer->copy((char*) header, headerSize) == -1)
+        ACE_ASSERT(false);
+
+    if (!pct.empty())
+        if (m_OutBuffer->copy((char*) pct.contents(), pct.size()) == -1)
+            ACE_ASSERT(false);
+
+    return 0;
 }
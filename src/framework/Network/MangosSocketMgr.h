@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include "Common.h"
+
 template <typename T>
 class ReactorRunnable;
 class ACE_Event_Handler;
@@ -31,6 +33,11 @@ class MangosSocketMgr
         void SetThreads(int v) { m_NetThreadsCount = v; }
         void SetTcpNodelay(bool v) { m_UseNoDelay = v; }
         void SetInterval(int v) { m_Interval = v * 1000; /* to microseconds */ }
+        /// Hold small writes up to 'v' milliseconds, 0 to disable
+        void SetCorkDelay(int v) { m_CorkDelay = v; }
+
+        /// Totals of all network threads: write syscalls, and packets they fully sent
+        void GetSendStats(uint64& sendCalls, uint64& packets) const;
 
         int Connect(int port, std::string const& address, SocketType*& sock);
     protected:
@@ -48,6 +55,7 @@ class MangosSocketMgr
         int m_SockOutUBuff;
         bool m_UseNoDelay;
         int m_Interval;
+        int m_CorkDelay;
 
         std::string m_addr;
         ACE_UINT16 m_port;
@@ -18,6 +18,7 @@
 
 #include "Log.h"
 #include "Common.h"
+#include "PacketSlab.h"
 #include "Config/Config.h"
 #include "Database/DatabaseEnv.h"
 
@@ -95,6 +96,7 @@ public:
         ++m_Connections;
         sock->AddReference();
         sock->reactor(m_Reactor);
+        sock->m_SendStats = &m_SendStats;
         m_NewSockets.insert(sock);
 
         return 0;
@@ -105,6 +107,11 @@ public:
         return m_Reactor;
     }
 
+    SocketSendStats const& GetSendStats() const
+    {
+        return m_SendStats;
+    }
+
 protected:
     void AddNewSockets()
     {
@@ -134,6 +141,8 @@ protected:
         DEBUG_LOG("Network Thread Starting");
 
         WorldDatabase.ThreadStart();
+        // received packets are allocated here and freed by the world/map threads
+        PacketSlab::InitThread();
 
         MANGOS_ASSERT(m_Reactor);
 
@@ -166,6 +175,7 @@ protected:
             }
         }
 
+        PacketSlab::ReleaseThread();
         WorldDatabase.ThreadEnd();
 
         DEBUG_LOG("Network Thread Exitting");
@@ -186,6 +196,8 @@ private:
 
     SocketSet m_NewSockets;
     ACE_Thread_Mutex m_NewSockets_Lock;
+
+    SocketSendStats m_SendStats;
 };
 
 template <typename SocketType>
@@ -195,6 +207,7 @@ MangosSocketMgr<SocketType>::MangosSocketMgr():
     m_SockOutKBuff(-1),
     m_SockOutUBuff(65536),
     m_Interval(10000),
+    m_CorkDelay(0),
     m_UseNoDelay(true),
     m_Acceptor(0),
     m_port(0)
@@ -213,9 +226,14 @@ int MangosSocketMgr<SocketType>::StartThreadsIfNeeded()
 {
     if (m_NetThreads)
         return 0;
+    // Corked sockets are only flushed by the network tick, it must not be longer than the delay
+    int interval = m_Interval;
+    if (m_CorkDelay > 0 && m_CorkDelay * 1000 < interval)
+        interval = m_CorkDelay * 1000;
+
     m_NetThreads = new ReactorRunnable<SocketType>[m_NetThreadsCount];
     for (size_t i = 0; i < m_NetThreadsCount; ++i)
-        m_NetThreads[i].Start(m_Interval);
+        m_NetThreads[i].Start(interval);
     return 0;
 }
 
@@ -315,6 +333,7 @@ int MangosSocketMgr<SocketType>::OnSocketOpen(SocketType* sock)
     }
 
     sock->m_OutBufferSize = static_cast<size_t>(m_SockOutUBuff);
+    sock->m_CorkDelay = m_CorkDelay > 0 ? static_cast<uint32>(m_CorkDelay) : 0;
 
     // we skip the Acceptor Thread
     size_t min = 1;
@@ -328,6 +347,23 @@ int MangosSocketMgr<SocketType>::OnSocketOpen(SocketType* sock)
     return m_NetThreads[min].AddSocket(sock);
 }
 
+template <typename SocketType>
+void MangosSocketMgr<SocketType>::GetSendStats(uint64& sendCalls, uint64& packets) const
+{
+    sendCalls = 0;
+    packets = 0;
+
+    if (!m_NetThreads)
+        return;
+
+    for (size_t i = 0; i < m_NetThreadsCount; ++i)
+    {
+        SocketSendStats const& stats = m_NetThreads[i].GetSendStats();
+        sendCalls += stats.sendCalls.load(std::memory_order_relaxed);
+        packets += stats.packets.load(std::memory_order_relaxed);
+    }
+}
+
 template <typename SocketType>
 int MangosSocketMgr<SocketType>::Connect(int port, std::string const& address, SocketType*& handler)
 {
@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _DIRTYLIST
+#define _DIRTYLIST
+
+#include <cstddef>
+#include <vector>
+
+//============================================
+// Intrusive part of a DirtyList: position of the object in the list it belongs to.
+
+class DirtyListElement
+{
+    private:
+
+        template <class T, DirtyListElement& (T::*)()> friend class DirtyList;
+
+        void const* iOwner;
+        std::size_t iIndex;
+
+    public:
+
+        DirtyListElement() : iOwner(nullptr), iIndex(0) { }
+
+        bool isInList() const { return iOwner != nullptr; }
+};
+
+//============================================
+// Contiguous set of objects pointers, with O(1) insert, remove and lookup.
+// Each object stores its own position, through the 'Element' accessor, so an
+// object can be in at most one list of a given kind. Removal swaps the last
+// element in place: order is not kept, except by erase(first, last).
+
+template <class T, DirtyListElement& (T::*Element)()>
+class DirtyList
+{
+    public:
+
+        typedef typename std::vector<T*>::const_iterator const_iterator;
+
+        DirtyList() { }
+        // Objects still listed outlive the list: they must not point to it anymore
+        ~DirtyList() { clear(); }
+
+        bool insert(T* obj)
+        {
+            DirtyListElement& elem = (obj->*Element)();
+            if (elem.iOwner)
+                return false;
+            elem.iOwner = this;
+            elem.iIndex = iItems.size();
+            iItems.push_back(obj);
+            return true;
+        }
+
+        bool erase(T* obj)
+        {
+            DirtyListElement& elem = (obj->*Element)();
+            if (elem.iOwner != this)
+                return false;
+            T* last = iItems.back();
+            iItems[elem.iIndex] = last;
+            (last->*Element)().iIndex = elem.iIndex;
+            iItems.pop_back();
+            elem.iOwner = nullptr;
+            return true;
+        }
+
+        // Removes [first, last), the remaining elements keep their order
+        void erase(std::size_t first, std::size_t last)
+        {
+            if (first >= last)
+                return;
+            for (std::size_t i = first; i < last; ++i)
+                (iItems[i]->*Element)().iOwner = nullptr;
+            for (std::size_t i = last; i < iItems.size(); ++i)
+            {
+                iItems[first + i - last] = iItems[i];
+                (iItems[i]->*Element)().iIndex = first + i - last;
+            }
+            iItems.resize(iItems.size() - (last - first));
+        }
+
+        bool contains(T* obj) { return (obj->*Element)().iOwner == this; }
+
+        void clear()
+        {
+            for (std::size_t i = 0; i < iItems.size(); ++i)
+                (iItems[i]->*Element)().iOwner = nullptr;
+            iItems.clear();
+        }
+
+        std::size_t size() const { return iItems.size(); }
+        bool empty() const { return iItems.empty(); }
+        T* operator[](std::size_t i) const { return iItems[i]; }
+        const_iterator begin() const { return iItems.begin(); }
+        const_iterator end() const { return iItems.end(); }
+
+    private:
+
+        DirtyList(DirtyList const&);
+        DirtyList& operator=(DirtyList const&);
+
+        std::vector<T*> iItems;
+};
+
+#endif
@@ -19,10 +19,13 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
     m_aborting = false;
+    m_sequence = 0;
 }
 
 EventProcessor::~EventProcessor()
@@ -36,12 +39,12 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_queue.empty() && m_queue.front().execTime <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_queue.front().event;
+        std::pop_heap(m_queue.begin(), m_queue.end(), RunsAfter());
+        m_queue.pop_back();
 
         if (!Event->to_Abort)
         {
@@ -64,26 +67,21 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
-    // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    // first, abort all existing events. Abort may add events: work on our own copy.
+    std::vector<QueuedEvent> queue;
+    queue.swap(m_queue);
+    for (std::vector<QueuedEvent>::const_iterator i = queue.begin(); i != queue.end(); ++i)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
-
-            if (!force)                                      // need per-element cleanup
-                m_events.erase (i_old);
-        }
+        i->event->to_Abort = true;
+        i->event->Abort(m_time);
+        if (force || i->event->IsDeletable())
+            delete i->event;
+        else
+            m_queue.push_back(*i);
     }
 
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
+    // the kept events keep their place
+    std::make_heap(m_queue.begin(), m_queue.end(), RunsAfter());
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -92,10 +90,22 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    QueuedEvent queued;
+    queued.execTime = e_time;
+    queued.sequence = m_sequence++;
+    queued.event = Event;
+    m_queue.push_back(queued);
+    std::push_heap(m_queue.begin(), m_queue.end(), RunsAfter());
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset)
 {
     return m_time + t_offset;
 }
+
+void EventProcessor::GetEvents(std::vector<BasicEvent*>& events) const
+{
+    events.reserve(events.size() + m_queue.size());
+    for (std::vector<QueuedEvent>::const_iterator i = m_queue.begin(); i != m_queue.end(); ++i)
+        events.push_back(i->event);
+}
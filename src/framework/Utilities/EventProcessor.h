@@ -22,7 +22,7 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -56,8 +56,6 @@ class BasicEvent
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
-
 class EventProcessor
 {
     public:
@@ -70,11 +68,34 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         uint64 CalculateTime(uint64 t_offset);
 
+        bool HasEvents() const { return !m_queue.empty(); }
+        // Copies the pending events, in no particular order: handling them may add events
+        void GetEvents(std::vector<BasicEvent*>& events) const;
+
     //protected:
 
         uint64 m_time;
-        EventList m_events;
         bool m_aborting;
+
+    private:
+        struct QueuedEvent
+        {
+            uint64 execTime;
+            uint64 sequence;                                // events planned at the same time run in insertion order
+            BasicEvent* event;
+        };
+
+        struct RunsAfter
+        {
+            bool operator()(QueuedEvent const& lhs, QueuedEvent const& rhs) const
+            {
+                return lhs.execTime != rhs.execTime ? lhs.execTime > rhs.execTime : lhs.sequence > rhs.sequence;
+            }
+        };
+
+        // Binary min heap: no allocation per event once the vector has grown
+        std::vector<QueuedEvent> m_queue;
+        uint64 m_sequence;
 };
 
 #endif
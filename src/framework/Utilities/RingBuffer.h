@@ -0,0 +1,222 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _RINGBUFFER
+#define _RINGBUFFER
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+//============================================
+// Bounded lock-free FIFO, any number of producers and a single consumer.
+// Each slot carries a sequence number telling whether it is free for the
+// producer of turn 'pos' (sequence == pos) or filled for the consumer
+// (sequence == pos + 1). Producers only contend on a single CAS, the
+// consumer never writes a shared counter.
+
+template <class T>
+class MPSCRingBuffer
+{
+    public:
+
+        // Capacity is rounded up to a power of two
+        explicit MPSCRingBuffer(std::size_t capacity) : iEnqueuePos(0), iDequeuePos(0)
+        {
+            std::size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            iMask = size - 1;
+            iSlots.reset(new Slot[size]);
+            for (std::size_t i = 0; i < size; ++i)
+                iSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        // Any thread. Returns false, leaving 'value' untouched, when the buffer is full.
+        bool push(T&& value)
+        {
+            std::size_t pos = iEnqueuePos.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot& slot = iSlots[pos & iMask];
+                std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+                if (diff == 0)
+                {
+                    if (iEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        slot.value = std::move(value);
+                        slot.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = iEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Consumer thread only
+        bool pop(T& value)
+        {
+            Slot& slot = iSlots[iDequeuePos & iMask];
+            if (slot.sequence.load(std::memory_order_acquire) != iDequeuePos + 1)
+                return false;
+            value = std::move(slot.value);
+            slot.value = T();
+            slot.sequence.store(iDequeuePos + iMask + 1, std::memory_order_release);
+            ++iDequeuePos;
+            return true;
+        }
+
+        // Consumer thread only. Next value to pop, or NULL if none
+        T* front()
+        {
+            Slot& slot = iSlots[iDequeuePos & iMask];
+            if (slot.sequence.load(std::memory_order_acquire) != iDequeuePos + 1)
+                return NULL;
+            return &slot.value;
+        }
+
+        // Consumer thread only
+        bool empty() const
+        {
+            return iSlots[iDequeuePos & iMask].sequence.load(std::memory_order_acquire) != iDequeuePos + 1;
+        }
+
+        std::size_t capacity() const { return iMask + 1; }
+
+    private:
+
+        MPSCRingBuffer(MPSCRingBuffer const&);
+        MPSCRingBuffer& operator=(MPSCRingBuffer const&);
+
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Slot[]> iSlots;
+        std::size_t iMask;
+        char iPad1[64];
+        std::atomic<std::size_t> iEnqueuePos;
+        char iPad2[64];
+        std::size_t iDequeuePos;
+};
+
+//============================================
+// Unbounded FIFO, any number of producers and one consumer at a time.
+// Values go through a MPSCRingBuffer, a mutex protected list only takes
+// the overflow. Once something overflowed, a producer keeps using the
+// list until the consumer took it, and the consumer only takes the list
+// when the ring is empty (checked under the lock), so the values of each
+// producer keep their order.
+
+template <class T>
+class MPSCQueue
+{
+    public:
+
+        explicit MPSCQueue(std::size_t capacity = 64) : iRing(capacity), iOverflowSize(0) {}
+
+        // Any thread
+        void add(T const& value)
+        {
+            if (!iOverflowSize.load(std::memory_order_acquire))
+            {
+                T copy(value);
+                if (iRing.push(std::move(copy)))
+                    return;
+            }
+
+            std::lock_guard<std::mutex> guard(iOverflowLock);
+            iOverflow.push_back(value);
+            iOverflowSize.store(iOverflow.size(), std::memory_order_release);
+        }
+
+        // Consumer thread only
+        bool next(T& result)
+        {
+            T* value = front();
+            if (!value)
+                return false;
+            result = std::move(*value);
+            pop();
+            return true;
+        }
+
+        // Consumer thread only. Leaves the value in the queue if the checker refuses it.
+        template<class Checker>
+        bool next(T& result, Checker& check)
+        {
+            T* value = front();
+            if (!value || !check.Process(*value))
+                return false;
+            result = std::move(*value);
+            pop();
+            return true;
+        }
+
+    private:
+
+        MPSCQueue(MPSCQueue const&);
+        MPSCQueue& operator=(MPSCQueue const&);
+
+        T* front()
+        {
+            if (!iSpilled.empty())
+                return &iSpilled.front();
+
+            if (T* value = iRing.front())
+                return value;
+
+            // Ring empty: what overflowed before is now the oldest. Check the ring again
+            // under the lock, a producer fills the ring before overflowing.
+            if (iOverflowSize.load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> guard(iOverflowLock);
+                if (T* value = iRing.front())
+                    return value;
+                iSpilled.swap(iOverflow);
+                iOverflowSize.store(0, std::memory_order_release);
+            }
+            return iSpilled.empty() ? NULL : &iSpilled.front();
+        }
+
+        void pop()
+        {
+            if (!iSpilled.empty())
+                iSpilled.pop_front();
+            else
+            {
+                T value;
+                iRing.pop(value);
+            }
+        }
+
+        MPSCRingBuffer<T> iRing;
+        std::atomic<std::size_t> iOverflowSize;
+        std::mutex iOverflowLock;
+        std::deque<T> iOverflow;
+        // consumer side copy of iOverflow
+        std::deque<T> iSpilled;
+};
+
+#endif
@@ -77,7 +77,7 @@ TotemAI::UpdateAI(const uint32 /*diff*/)
 
         MaNGOS::NearestAttackableUnitInObjectRangeCheck u_check(m_creature, m_creature, max_range);
         MaNGOS::UnitLastSearcher<MaNGOS::NearestAttackableUnitInObjectRangeCheck> checker(victim, u_check);
-        Cell::VisitAllObjects(m_creature, checker, max_range);
+        Cell::VisitUnitsInRange(m_creature, checker, max_range, true);
     }
 
     // If have target
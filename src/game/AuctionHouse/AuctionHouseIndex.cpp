@@ -0,0 +1,409 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "AuctionHouseIndex.h"
+#include "AuctionHouseMgr.h"
+#include "Item.h"
+#include "ObjectMgr.h"
+#include "Player.h"
+#include "SpellMgr.h"
+#include "Util.h"
+#include "WorldPacket.h"
+#include "WorldSession.h"
+#include <algorithm>
+
+namespace
+{
+    bool AuctionIdLess(AuctionEntry const* left, AuctionEntry const* right)
+    {
+        return left->Id < right->Id;
+    }
+
+    // Merge cursor on the auctions of an item template
+    struct AuctionCursor
+    {
+        std::vector<AuctionEntry*> const* auctions;
+        uint32 pos;
+        bool checked;                                       // auctions not all listed: IP locks or usable filter
+
+        uint32 GetId() const { return (*auctions)[pos]->Id; }
+    };
+
+    // Min heap on the id of the next auction
+    bool CursorAfter(AuctionCursor const& left, AuctionCursor const& right)
+    {
+        return left.GetId() > right.GetId();
+    }
+}
+
+AuctionHouseIndex::AuctionHouseIndex()
+{
+}
+
+void AuctionHouseIndex::Insert(AuctionEntry* auction)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return;
+
+    // Item locales are loaded before the auctions
+    if (m_nameTrigrams.empty())
+        m_nameTrigrams.resize(sObjectMgr.GetLocalesCount() + 1);
+
+    std::pair<IndexedItems::iterator, bool> inserted = m_items.insert(IndexedItems::value_type(proto->ItemId, IndexedItem()));
+    IndexedItem& item = inserted.first->second;
+    if (inserted.second)
+    {
+        item.entry = proto->ItemId;
+        item.itemClass = proto->Class;
+        item.subClass = proto->SubClass;
+        item.inventoryType = proto->InventoryType;
+        item.quality = proto->Quality;
+        item.requiredLevel = proto->RequiredLevel;
+        item.ipLockedCount = 0;
+
+        // Same names as Utf8FitTo would get. An empty name never matches a name search.
+        std::wstring defaultName;
+        if (!*proto->Name1 || !Utf8toWStr(proto->Name1, defaultName))
+            defaultName.clear();
+        wstrToLower(defaultName);
+
+        ItemLocale const* il = sObjectMgr.GetItemLocale(proto->ItemId);
+        item.names.resize(m_nameTrigrams.size(), defaultName);
+        for (uint32 locIdx = 0; locIdx + 1 < item.names.size(); ++locIdx)
+        {
+            if (defaultName.empty() || !il || il->Name.size() <= locIdx || il->Name[locIdx].empty())
+                continue;
+
+            std::wstring& name = item.names[locIdx + 1];
+            if (!Utf8toWStr(il->Name[locIdx], name))
+                name.clear();
+            wstrToLower(name);
+        }
+
+        AddItem(item);
+    }
+
+    // Auction ids mostly increase, insert from the end
+    item.auctions.insert(std::upper_bound(item.auctions.begin(), item.auctions.end(), auction, AuctionIdLess), auction);
+    if (!auction->lockedIpAddress.empty())
+        ++item.ipLockedCount;
+}
+
+void AuctionHouseIndex::Remove(AuctionEntry const* auction)
+{
+    IndexedItems::iterator itr = m_items.find(auction->itemTemplate);
+    if (itr == m_items.end())
+        return;
+
+    IndexedItem& item = itr->second;
+    std::vector<AuctionEntry*>::iterator pos = std::lower_bound(item.auctions.begin(), item.auctions.end(), auction, AuctionIdLess);
+    if (pos == item.auctions.end() || *pos != auction)
+        return;
+
+    item.auctions.erase(pos);
+    if (!auction->lockedIpAddress.empty())
+        --item.ipLockedCount;
+
+    if (item.auctions.empty())
+    {
+        RemoveItem(item);
+        m_items.erase(itr);
+    }
+}
+
+void AuctionHouseIndex::OnIpUnlocked(AuctionEntry const* auction)
+{
+    IndexedItems::iterator itr = m_items.find(auction->itemTemplate);
+    if (itr != m_items.end())
+        --itr->second.ipLockedCount;
+}
+
+template<class Index, class Key>
+void AuctionHouseIndex::RemovePosting(Index& index, Key const& key, uint32 entry)
+{
+    typename Index::iterator list = index.find(key);
+    if (list == index.end())
+        return;
+
+    PostingList::iterator itr = std::lower_bound(list->second.begin(), list->second.end(), entry);
+    if (itr != list->second.end() && *itr == entry)
+        list->second.erase(itr);
+
+    if (list->second.empty())
+        index.erase(list);
+}
+
+void AuctionHouseIndex::AddItem(IndexedItem& item)
+{
+    AddPosting(m_byClass[item.itemClass], item.entry);
+    AddPosting(m_bySubClass[item.itemClass << 16 | item.subClass], item.entry);
+    AddPosting(m_bySlot[item.inventoryType], item.entry);
+    AddPosting(m_byQuality[item.quality], item.entry);
+    AddPosting(m_byLevel[item.requiredLevel], item.entry);
+
+    std::vector<uint64> trigrams;
+    for (uint32 slot = 0; slot < item.names.size(); ++slot)
+    {
+        GetTrigrams(item.names[slot], trigrams);
+        for (std::vector<uint64>::const_iterator itr = trigrams.begin(); itr != trigrams.end(); ++itr)
+            AddPosting(m_nameTrigrams[slot][*itr], item.entry);
+    }
+}
+
+void AuctionHouseIndex::RemoveItem(IndexedItem const& item)
+{
+    // Empty posting lists are erased, a search with a missing key has no result
+    RemovePosting(m_byClass, item.itemClass, item.entry);
+    RemovePosting(m_bySubClass, item.itemClass << 16 | item.subClass, item.entry);
+    RemovePosting(m_bySlot, item.inventoryType, item.entry);
+    RemovePosting(m_byQuality, item.quality, item.entry);
+    RemovePosting(m_byLevel, item.requiredLevel, item.entry);
+
+    std::vector<uint64> trigrams;
+    for (uint32 slot = 0; slot < item.names.size(); ++slot)
+    {
+        GetTrigrams(item.names[slot], trigrams);
+        for (std::vector<uint64>::const_iterator itr = trigrams.begin(); itr != trigrams.end(); ++itr)
+            RemovePosting(m_nameTrigrams[slot], *itr, item.entry);
+    }
+}
+
+void AuctionHouseIndex::AddPosting(PostingList& list, uint32 entry)
+{
+    list.insert(std::lower_bound(list.begin(), list.end(), entry), entry);
+}
+
+void AuctionHouseIndex::GetTrigrams(std::wstring const& name, std::vector<uint64>& trigrams)
+{
+    trigrams.clear();
+    for (size_t i = 0; i + 3 <= name.size(); ++i)
+        trigrams.push_back(uint64(name[i] & 0x1FFFFF) << 42 | uint64(name[i + 1] & 0x1FFFFF) << 21 | uint64(name[i + 2] & 0x1FFFFF));
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+// Smallest set of posting lists holding all the templates the query may match.
+// Returns false if no filter is indexed, 'lists' is left empty when nothing can match.
+bool AuctionHouseIndex::SelectPostingLists(AuctionHouseClientQuery const& query, uint32 localeSlot, PostingLists& lists) const
+{
+    bool selected = false;
+    size_t selectedSize = 0;
+    PostingLists candidate;
+
+    // Posting lists of a filter do not overlap, the smallest union is kept
+    auto select = [&]()
+    {
+        size_t size = 0;
+        for (PostingLists::const_iterator itr = candidate.begin(); itr != candidate.end(); ++itr)
+            size += (*itr)->size();
+        if (!selected || size < selectedSize)
+        {
+            lists.swap(candidate);
+            selectedSize = size;
+            selected = true;
+        }
+        candidate.clear();
+    };
+    auto addList = [&](UNORDERED_MAP<uint32, PostingList> const& index, uint32 key)
+    {
+        UNORDERED_MAP<uint32, PostingList>::const_iterator itr = index.find(key);
+        if (itr != index.end())
+            candidate.push_back(&itr->second);
+        select();
+    };
+
+    if (query.auctionMainCategory != 0xffffffff)
+    {
+        if (query.auctionSubCategory != 0xffffffff)
+            addList(m_bySubClass, query.auctionMainCategory << 16 | query.auctionSubCategory);
+        else
+            addList(m_byClass, query.auctionMainCategory);
+    }
+
+    if (query.auctionSlotID != 0xffffffff)
+        addList(m_bySlot, query.auctionSlotID);
+
+    if (query.quality != 0xffffffff)
+    {
+        for (std::map<uint32, PostingList>::const_iterator itr = m_byQuality.lower_bound(query.quality); itr != m_byQuality.end(); ++itr)
+            candidate.push_back(&itr->second);
+        select();
+    }
+
+    if (query.levelmin != 0x00)
+    {
+        for (std::map<uint32, PostingList>::const_iterator itr = m_byLevel.lower_bound(query.levelmin); itr != m_byLevel.end(); ++itr)
+        {
+            if (query.levelmax != 0x00 && itr->first > query.levelmax)
+                break;
+            candidate.push_back(&itr->second);
+        }
+        select();
+    }
+
+    // Every trigram of the searched name is in the matching names
+    std::vector<uint64> trigrams;
+    GetTrigrams(query.wsearchedname, trigrams);
+    if (!trigrams.empty())
+    {
+        TrigramIndex const& names = m_nameTrigrams[localeSlot];
+        PostingList const* smallest = nullptr;
+        for (std::vector<uint64>::const_iterator itr = trigrams.begin(); itr != trigrams.end(); ++itr)
+        {
+            TrigramIndex::const_iterator list = names.find(*itr);
+            if (list == names.end())
+            {
+                smallest = nullptr;
+                break;
+            }
+            if (!smallest || list->second.size() < smallest->size())
+                smallest = &list->second;
+        }
+        if (smallest)
+            candidate.push_back(smallest);
+        select();
+    }
+
+    return selected;
+}
+
+bool AuctionHouseIndex::MatchItem(IndexedItem const& item, AuctionHouseClientQuery const& query, uint32 localeSlot) const
+{
+    if (query.auctionMainCategory != 0xffffffff && item.itemClass != query.auctionMainCategory)
+        return false;
+
+    if (query.auctionSubCategory != 0xffffffff && item.subClass != query.auctionSubCategory)
+        return false;
+
+    if (query.auctionSlotID != 0xffffffff && item.inventoryType != query.auctionSlotID)
+        return false;
+
+    if (query.quality != 0xffffffff && item.quality < query.quality)
+        return false;
+
+    if (query.levelmin != 0x00 && (item.requiredLevel < query.levelmin || (query.levelmax != 0x00 && item.requiredLevel > query.levelmax)))
+        return false;
+
+    if (!query.wsearchedname.empty() && item.names[localeSlot].find(query.wsearchedname) == std::wstring::npos)
+        return false;
+
+    return true;
+}
+
+void AuctionHouseIndex::BuildListAuctionItems(WorldPacket& data, Player* player, AuctionHouseClientQuery const& query,
+    uint32& count, uint32& totalcount) const
+{
+    if (m_items.empty())
+        return;
+
+    uint32 localeSlot = GetLocaleSlot(player->GetSession()->GetSessionDbLocaleIndex());
+    std::string const& clientIp = player->GetSession()->GetRemoteAddress();
+
+    std::vector<IndexedItem const*> matches;
+    PostingLists lists;
+    if (SelectPostingLists(query, localeSlot, lists))
+    {
+        for (PostingLists::const_iterator list = lists.begin(); list != lists.end(); ++list)
+            for (PostingList::const_iterator entry = (*list)->begin(); entry != (*list)->end(); ++entry)
+            {
+                IndexedItem const& item = m_items.find(*entry)->second;
+                if (MatchItem(item, query, localeSlot))
+                    matches.push_back(&item);
+            }
+    }
+    else
+    {
+        for (IndexedItems::const_iterator itr = m_items.begin(); itr != m_items.end(); ++itr)
+            if (MatchItem(itr->second, query, localeSlot))
+                matches.push_back(&itr->second);
+    }
+
+    std::vector<AuctionCursor> cursors;
+    cursors.reserve(matches.size());
+    for (std::vector<IndexedItem const*>::const_iterator itr = matches.begin(); itr != matches.end(); ++itr)
+    {
+        IndexedItem const& item = **itr;
+
+        // Known recipes
+        if (query.usable != 0x00 && item.itemClass == ITEM_CLASS_RECIPE)
+            if (ItemPrototype const* proto = ObjectMgr::GetItemPrototype(item.entry))
+                if (SpellEntry const* spell = sSpellMgr.GetSpellEntry(proto->Spells[0].SpellId))
+                    if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                        continue;
+
+        AuctionCursor cursor;
+        cursor.auctions = &item.auctions;
+        cursor.pos = 0;
+        cursor.checked = query.usable != 0x00 || item.ipLockedCount;
+        cursors.push_back(cursor);
+    }
+
+    auto isListed = [&](AuctionEntry const* auction)
+    {
+        // IP locked auction
+        if (!auction->lockedIpAddress.empty() && auction->lockedIpAddress != clientIp)
+            return false;
+
+        Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
+        if (!item)
+            return false;
+
+        if (query.usable != 0x00 && player->CanUseItem(item) != EQUIP_ERR_OK)
+            return false;
+
+        return true;
+    };
+
+    // Merge in id order until the page is full
+    uint32 listed = 0;
+    std::make_heap(cursors.begin(), cursors.end(), CursorAfter);
+    while (!cursors.empty() && count < 50)
+    {
+        std::pop_heap(cursors.begin(), cursors.end(), CursorAfter);
+        AuctionCursor& cursor = cursors.back();
+        AuctionEntry* auction = (*cursor.auctions)[cursor.pos];
+        if (isListed(auction))
+        {
+            if (listed >= query.listfrom)
+            {
+                ++count;
+                auction->BuildAuctionInfo(data);
+            }
+            ++listed;
+        }
+
+        if (++cursor.pos < cursor.auctions->size())
+            std::push_heap(cursors.begin(), cursors.end(), CursorAfter);
+        else
+            cursors.pop_back();
+    }
+
+    // Then only count the remaining auctions, their items are not looked up unless needed
+    totalcount = listed;
+    for (std::vector<AuctionCursor>::const_iterator itr = cursors.begin(); itr != cursors.end(); ++itr)
+    {
+        if (!itr->checked)
+        {
+            totalcount += itr->auctions->size() - itr->pos;
+            continue;
+        }
+        for (uint32 pos = itr->pos; pos < itr->auctions->size(); ++pos)
+            if (isListed((*itr->auctions)[pos]))
+                ++totalcount;
+    }
+}
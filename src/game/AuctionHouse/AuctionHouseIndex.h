@@ -0,0 +1,93 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _AUCTION_HOUSE_INDEX_H
+#define _AUCTION_HOUSE_INDEX_H
+
+#include "Common.h"
+#include <map>
+#include <string>
+#include <vector>
+
+struct AuctionEntry;
+struct AuctionHouseClientQuery;
+class Player;
+class WorldPacket;
+
+/**
+ * Search index of an auction house. Everything the client filters on but the usable flag
+ * depends on the item template, so the auctions are grouped by template: posting lists of
+ * templates by class, subclass, slot, quality and required level, and a trigram index over
+ * the lowercased (localized) names. A search only visits the templates of its most selective
+ * posting list, then merges their auctions, kept sorted by id, in the AuctionsMap order.
+ * The page is built while merging, the auctions after it are only counted.
+ * Modified with the auctions in the world thread, searched by the async tasks.
+ */
+class AuctionHouseIndex
+{
+    public:
+        AuctionHouseIndex();
+
+        void Insert(AuctionEntry* auction);
+        void Remove(AuctionEntry const* auction);
+        // The auction is not IP locked anymore
+        void OnIpUnlocked(AuctionEntry const* auction);
+
+        void BuildListAuctionItems(WorldPacket& data, Player* player, AuctionHouseClientQuery const& query,
+            uint32& count, uint32& totalcount) const;
+
+        uint32 GetIndexedItemsCount() const { return m_items.size(); }
+
+    private:
+        typedef std::vector<uint32> PostingList;            // item template entries, sorted
+        typedef std::vector<PostingList const*> PostingLists;
+        typedef UNORDERED_MAP<uint64, PostingList> TrigramIndex;
+
+        // Item template with auctions in the house
+        struct IndexedItem
+        {
+            uint32 entry;
+            uint32 itemClass;
+            uint32 subClass;
+            uint32 inventoryType;
+            uint32 quality;
+            uint32 requiredLevel;
+            std::vector<std::wstring> names;                // lowercased, one per locale slot
+            std::vector<AuctionEntry*> auctions;            // sorted by id
+            uint32 ipLockedCount;
+        };
+        typedef UNORDERED_MAP<uint32, IndexedItem> IndexedItems;
+
+        void AddItem(IndexedItem& item);
+        void RemoveItem(IndexedItem const& item);
+        uint32 GetLocaleSlot(int locIdx) const { return locIdx >= 0 && uint32(locIdx + 1) < m_nameTrigrams.size() ? locIdx + 1 : 0; }
+        bool SelectPostingLists(AuctionHouseClientQuery const& query, uint32 localeSlot, PostingLists& lists) const;
+        bool MatchItem(IndexedItem const& item, AuctionHouseClientQuery const& query, uint32 localeSlot) const;
+
+        static void AddPosting(PostingList& list, uint32 entry);
+        template<class Index, class Key> static void RemovePosting(Index& index, Key const& key, uint32 entry);
+        static void GetTrigrams(std::wstring const& name, std::vector<uint64>& trigrams);
+
+        IndexedItems m_items;
+        UNORDERED_MAP<uint32, PostingList> m_byClass;
+        UNORDERED_MAP<uint32, PostingList> m_bySubClass;    // class << 16 | subclass
+        UNORDERED_MAP<uint32, PostingList> m_bySlot;
+        std::map<uint32, PostingList> m_byQuality;
+        std::map<uint32, PostingList> m_byLevel;
+        std::vector<TrigramIndex> m_nameTrigrams;           // per locale slot: 0 default, i + 1 for locale index i
+};
+
+#endif
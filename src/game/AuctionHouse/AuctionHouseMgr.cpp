@@ -41,12 +41,14 @@ INSTANTIATE_SINGLETON_1(AuctionHouseMgr);
 
 bool AuctionHouseObject::RemoveAuction(uint32 id)
 {
-    if (AuctionsMap.erase(id))
-    {
-        sObjectMgr.FreeAuctionID(id);
-        return true;
-    }
-    return false;
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    AuctionsIndex.Remove(itr->second);
+    AuctionsMap.erase(itr);
+    sObjectMgr.FreeAuctionID(id);
+    return true;
 }
 
 AuctionHouseMgr::AuctionHouseMgr()
@@ -602,8 +604,11 @@ void AuctionHouseObject::Update()
     AuctionEntryMap::iterator next;
     for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); itr = next)
     {
-        if (itr->second->depositTime + 5*60 < curTime) // Locked for 5 minutes on IP to prevent AH snipping
+        if (!itr->second->lockedIpAddress.empty() && itr->second->depositTime + 5*60 < curTime) // Locked for 5 minutes on IP to prevent AH snipping
+        {
+            AuctionsIndex.OnIpUnlocked(itr->second);
             itr->second->lockedIpAddress.clear();
+        }
 
         next = itr;
         ++next;
@@ -635,8 +640,9 @@ void AuctionHouseObject::Update()
             ///- In any case clear the auction
             itr->second->DeleteFromDB();
             sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
-            delete itr->second;
-            RemoveAuction(itr->first);
+            AuctionEntry* auction = itr->second;
+            RemoveAuction(auction->Id);
+            delete auction;
         }
     }
 }
@@ -695,77 +701,7 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
         return;
     }
 
-    time_t currTime = sWorld.GetGameTime();
-    std::string const& clientIp = player->GetSession()->GetRemoteAddress();
-    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
-
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
-    {
-        AuctionEntry *Aentry = itr->second;
-        Item *item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
-            continue;
-
-        {
-            ItemPrototype const *proto = item->GetProto();
-
-            if (query.auctionMainCategory != 0xffffffff && proto->Class != query.auctionMainCategory)
-                continue;
-
-            if (query.auctionSubCategory != 0xffffffff && proto->SubClass != query.auctionSubCategory)
-                continue;
-
-            if (query.auctionSlotID != 0xffffffff && proto->InventoryType != query.auctionSlotID)
-                continue;
-
-            if (query.quality != 0xffffffff && proto->Quality < query.quality)
-                continue;
-
-            if (query.levelmin != 0x00 && (proto->RequiredLevel < query.levelmin || (query.levelmax != 0x00 && proto->RequiredLevel > query.levelmax)))
-                continue;
-
-            if (query.usable != 0x00 && player->CanUseItem(item) != EQUIP_ERR_OK)
-                continue;
-
-            if (query.usable != 0x00 && proto->Class == ITEM_CLASS_RECIPE)
-                if (SpellEntry const* spell = sSpellMgr.GetSpellEntry(proto->Spells[0].SpellId))
-                    if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                        continue;
-
-            // IP locked auction
-            if (!Aentry->lockedIpAddress.empty() && Aentry->lockedIpAddress != clientIp)
-                continue;
-
-            if (!query.wsearchedname.empty())
-            {
-                std::string name = proto->Name1;
-                if (name.empty())
-                    continue;
-
-                // local name
-                if (loc_idx >= 0)
-                {
-                    ItemLocale const *il = sObjectMgr.GetItemLocale(proto->ItemId);
-                    if (il)
-                    {
-                        if (il->Name.size() > size_t(loc_idx) && !il->Name[loc_idx].empty())
-                            name = il->Name[loc_idx];
-                    }
-                }
-
-                if (!Utf8FitTo(name, query.wsearchedname))
-                    continue;
-            }
-
-            if (count < 50 && totalcount >= query.listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
-            }
-        }
-
-        ++totalcount;
-    }
+    AuctionsIndex.BuildListAuctionItems(data, player, query, count, totalcount);
 }
 
 // this function inserts to WorldPacket auction's data
@@ -819,12 +755,14 @@ uint32 AuctionEntry::GetAuctionOutBid() const
 void AuctionEntry::DeleteFromDB() const
 {
     //No SQL injection (Id is integer)
+    SqlAsyncKey asyncKey(Id);
     CharacterDatabase.PExecute("DELETE FROM auction WHERE id = '%u'", Id);
 }
 
 void AuctionEntry::SaveToDB() const
 {
     //No SQL injection (no strings)
+    SqlAsyncKey asyncKey(Id);
     CharacterDatabase.PExecute("INSERT INTO auction (id,houseid,itemguid,item_template,itemowner,buyoutprice,time,buyguid,lastbid,startbid,deposit) "
                                "VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '" UI64FMTD "', '%u', '%u', '%u', '%u')",
                                Id, auctionHouseEntry->houseId, itemGuidLow, itemTemplate, owner, buyout, (uint64)expireTime, bidder, bid, startbid, deposit);
@@ -27,6 +27,7 @@
 #include "Policies/Singleton.h"
 #include "DBCStructure.h"
 #include "Log.h"
+#include "AuctionHouseIndex.h"
 
 class Item;
 class Player;
@@ -112,6 +113,7 @@ class AuctionHouseObject
         {
             MANGOS_ASSERT( ah );
             AuctionsMap[ah->Id] = ah;
+            AuctionsIndex.Insert(ah);
         }
 
         AuctionEntry* GetAuction(uint32 id) const
@@ -131,6 +133,7 @@ class AuctionHouseObject
             uint32& count, uint32& totalcount);
     private:
         AuctionEntryMap AuctionsMap;
+        AuctionHouseIndex AuctionsIndex;
 };
 
 class AuctionHouseMgr
@@ -23,8 +23,10 @@
 #include "Log.h"
 #include "Errors.h"
 #include "Player.h"
+#include "World.h"
 
-Camera::Camera(Player* pl) : m_owner(*pl), m_source(pl)
+Camera::Camera(Player* pl) : m_owner(*pl), m_source(pl), m_visibilitySource(nullptr),
+    m_visibilityX(0.0f), m_visibilityY(0.0f), m_visibilityDistance(0.0f)
 {
     m_source->GetViewPoint().Attach(this);
 }
@@ -151,6 +153,41 @@ void Camera::UpdateVisibilityForOwner()
     GetOwner()->m_visibleGUIDs_lock.release();
     Cell::VisitAllObjects(m_source, notifier, m_source->GetMap()->GetVisibilityDistance());
     notifier.Notify();
+    SaveVisibilityState();
+}
+
+void Camera::UpdateVisibilityForOwnerAfterMove()
+{
+    float visibilityDistance = m_source->GetMap()->GetVisibilityDistance();
+    if (!sWorld.getConfig(CONFIG_BOOL_VISIBILITY_INCREMENTAL) || m_visibilitySource != m_source ||
+        m_visibilityDistance != visibilityDistance || m_owner.IsTaxiFlying())
+    {
+        UpdateVisibilityForOwner();
+        return;
+    }
+
+    GetOwner()->m_visibleGUIDs_lock.acquire_read();
+    MaNGOS::VisibleNotifier notifier(*this); // Will copy m_clientGUIDs
+    GetOwner()->m_visibleGUIDs_lock.release();
+    notifier.SetIncremental(m_visibilityX, m_visibilityY, sWorld.getConfig(CONFIG_FLOAT_VISIBILITY_INCREMENTAL_NEAR),
+                            visibilityDistance - sWorld.getConfig(CONFIG_FLOAT_VISIBILITY_INCREMENTAL_EDGE));
+    Cell::VisitAllObjects(m_source, notifier, visibilityDistance);
+    notifier.Notify();
+    SaveVisibilityState();
+
+    if (sWorld.getConfig(CONFIG_BOOL_VISIBILITY_INCREMENTAL_CHECK))
+    {
+        MaNGOS::VisibilityConsistencyChecker checker(*this);
+        Cell::VisitAllObjects(m_source, checker, visibilityDistance);
+    }
+}
+
+void Camera::SaveVisibilityState()
+{
+    m_visibilitySource = m_source;
+    m_visibilityX = m_source->GetPositionX();
+    m_visibilityY = m_source->GetPositionY();
+    m_visibilityDistance = m_source->GetMap()->GetVisibilityDistance();
 }
 
 //////////////////
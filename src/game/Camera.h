@@ -57,6 +57,8 @@ class MANGOS_DLL_SPEC Camera
 
         // updates visibility of worldobjects around viewpoint for camera's owner
         void UpdateVisibilityForOwner();
+        // same, after a move of the viewpoint. Checks only what may have changed if Visibility.Incremental is enabled
+        void UpdateVisibilityForOwnerAfterMove();
 
     private:
         // called when viewpoint changes visibility state
@@ -69,6 +71,13 @@ class MANGOS_DLL_SPEC Camera
         WorldObject* m_source;
 
         void UpdateForCurrentViewPoint();
+        void SaveVisibilityState();
+
+        // viewpoint state at the last visibility update
+        WorldObject const* m_visibilitySource;
+        float m_visibilityX;
+        float m_visibilityY;
+        float m_visibilityDistance;
 
     public:
         GridReference<Camera>& GetGridRef() { return m_gridRef; }
@@ -137,6 +146,11 @@ public:
     {
         CameraCall(&Camera::UpdateVisibilityForOwner);
     }
+
+    void Call_UpdateVisibilityForOwnerAfterMove()
+    {
+        CameraCall(&Camera::UpdateVisibilityForOwnerAfterMove);
+    }
 };
 
 #endif
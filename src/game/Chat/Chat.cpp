@@ -249,6 +249,10 @@ ChatCommand * ChatHandler::getCommandTable()
         { NODE, "time",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugTimeCommand,                "", nullptr },
         { NODE, "moveflags",      SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugMoveFlagsCommand,           "", nullptr },
         { NODE, "movespline",     SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugMoveSplineCommand,          "", nullptr },
+        { NODE, "vmapbench",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugVmapBenchCommand,           "", nullptr },
+        { NODE, "procbench",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugProcBenchCommand,           "", nullptr },
+        { NODE, "eventbench",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugEventBenchCommand,          "", nullptr },
+        { NODE, "cellbench",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugCellBenchCommand,           "", nullptr },
         { NODE, "dump",           SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugRecvPacketDumpWrite,        "", nullptr },
         { NODE, "movemotion",     SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugMoveCommand,                "", nullptr },
         { NODE, "factionchange_items", SEC_ADMINISTRATOR, true, &ChatHandler::HandleFactionChangeItemsCommand,    "", nullptr },
@@ -1026,6 +1030,7 @@ ChatCommand * ChatHandler::getCommandTable()
         { MSTR, "wr",             SEC_PLAYER,         false, &ChatHandler::HandleWhisperRestrictionCommand,  "", nullptr },
         { MSTR, "pinfo",          SEC_GAMEMASTER,     true,  &ChatHandler::HandlePInfoCommand,               "", nullptr },
         { MSTR, "pbcast",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandlePBCastStatsCommand,         "", pbcastCommandTable },
+        { NODE, "perf",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandlePerfCommand,                "", nullptr },
         { NODE, "addons",         SEC_ADMINISTRATOR,  false, &ChatHandler::HandleListAddonsCommand,          "", nullptr },
         { NODE, "respawn",        SEC_ADMINISTRATOR,  false, &ChatHandler::HandleRespawnCommand,             "", nullptr },
         { NODE, "send",           SEC_MODERATOR,      true, nullptr,                                           "", sendCommandTable     },
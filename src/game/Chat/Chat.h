@@ -179,6 +179,10 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleDebugTimeCommand(char *);
         bool HandleDebugMoveFlagsCommand(char *);
         bool HandleDebugMoveSplineCommand(char *);
+        bool HandleDebugVmapBenchCommand(char *);
+        bool HandleDebugProcBenchCommand(char *);
+        bool HandleDebugEventBenchCommand(char *);
+        bool HandleDebugCellBenchCommand(char *);
         bool HandleDebugExp(char* );
         bool HandleVideoTurn(char* );
         bool HandleDebugLootTableCommand(char*);
@@ -459,6 +463,7 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleInstanceSwitchCommand(char* args);
         bool HandleInstanceContinentsCommand(char* args);
         bool HandleInstancePerfInfosCommand(char* args);
+        bool HandlePerfCommand(char* args);
         bool HandleInstanceBindingMode(char* args);
         bool HandlePBCastStatsCommand(char* args);
         bool HandlePBCastSetThreadsCommand(char* args);
@@ -47,6 +47,7 @@
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
 #include "CellImpl.h"
+#include "WorldSocket.h"
 #include <cctype>
 #include <iostream>
 #include <fstream>
@@ -2585,6 +2586,9 @@ bool ChatHandler::HandlePInfoCommand(char* args)
     PSendSysMessage(LANG_PINFO_LEVEL,  timeStr.c_str(), level, gold, silv, copp);
     if (Guild* guild = sGuildMgr.GetPlayerGuild(target_guid))
         PSendSysMessage("Guild: %s", playerLink(guild->GetName()).c_str());
+    if (WorldSocket* socket = target && target->GetSession() ? target->GetSession()->GetSocket() : nullptr)
+        PSendSysMessage("Network: %u bytes queued (max %u), %u packets in queue",
+            uint32(socket->GetQueuedBytes()), uint32(socket->GetMaxQueuedBytes()), uint32(socket->GetQueuedPacketsCount()));
     return true;
 }
 
@@ -1,5 +1,8 @@
 #include <string.h>
 #include <map>
+#include <chrono>
+#include <memory>
+#include <random>
 
 #include "Common.h"
 #include "Database/DatabaseEnv.h"
@@ -53,6 +56,7 @@
 // VMAPS
 #include "VMapFactory.h"
 #include "ModelInstance.h"
+#include "TemporarySummon.h"
 
 #define MAX_SPELL_EFFECTS 3
 
@@ -2292,6 +2296,346 @@ bool ChatHandler::HandleDebugMoveSplineCommand(char* args)
     return true;
 }
 
+// .debug vmapbench [$queries [$batchSize [$radius]]]
+// Times the vmap height and LoS queries of random points around the player, one call per
+// point against the batched calls, on the tiles currently loaded.
+bool ChatHandler::HandleDebugVmapBenchCommand(char* args)
+{
+    uint32 queries = 2000;
+    uint32 batchSize = 32;
+    float radius = 30.0f;
+    ExtractOptUInt32(&args, queries, queries);
+    ExtractOptUInt32(&args, batchSize, batchSize);
+    if (*args && !ExtractFloat(&args, radius))
+        return false;
+    if (!queries || !batchSize)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+    uint32 const mapId = player->GetMapId();
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+
+    std::vector<float> from(queries * 3);
+    std::vector<float> to(queries * 3);
+    for (uint32 i = 0; i < queries; ++i)
+    {
+        from[i * 3] = player->GetPositionX();
+        from[i * 3 + 1] = player->GetPositionY();
+        from[i * 3 + 2] = player->GetPositionZ() + 2.0f;
+        float const angle = rand_norm_f() * 2 * M_PI_F;
+        float const dist = rand_norm_f() * radius;
+        to[i * 3] = player->GetPositionX() + dist * cos(angle);
+        to[i * 3 + 1] = player->GetPositionY() + dist * sin(angle);
+        to[i * 3 + 2] = player->GetPositionZ() + rand_norm_f() * 10.0f;
+    }
+
+    std::vector<float> heights(queries);
+    std::vector<float> batchHeights(queries);
+    std::unique_ptr<bool[]> los(new bool[queries]);
+    std::unique_ptr<bool[]> batchLos(new bool[queries]);
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    for (uint32 i = 0; i < queries; ++i)
+        heights[i] = vmgr->getHeight(mapId, to[i * 3], to[i * 3 + 1], to[i * 3 + 2], DEFAULT_HEIGHT_SEARCH);
+    Clock::time_point heightDone = Clock::now();
+    for (uint32 i = 0; i < queries; ++i)
+        los[i] = vmgr->isInLineOfSight(mapId, from[i * 3], from[i * 3 + 1], from[i * 3 + 2], to[i * 3], to[i * 3 + 1], to[i * 3 + 2]);
+    Clock::time_point losDone = Clock::now();
+
+    for (uint32 i = 0; i < queries; i += batchSize)
+        vmgr->getHeights(mapId, &to[i * 3], std::min(batchSize, queries - i), DEFAULT_HEIGHT_SEARCH, &batchHeights[i]);
+    Clock::time_point batchHeightDone = Clock::now();
+    for (uint32 i = 0; i < queries; i += batchSize)
+        vmgr->isInLineOfSight(mapId, &from[i * 3], &to[i * 3], std::min(batchSize, queries - i), &batchLos[i]);
+    Clock::time_point batchLosDone = Clock::now();
+
+    uint32 heightDiffs = 0;
+    uint32 losDiffs = 0;
+    uint32 blocked = 0;
+    for (uint32 i = 0; i < queries; ++i)
+    {
+        if (fabs(heights[i] - batchHeights[i]) > 0.001f)
+            ++heightDiffs;
+        if (los[i] != batchLos[i])
+            ++losDiffs;
+        if (!los[i])
+            ++blocked;
+    }
+
+    typedef std::chrono::microseconds us;
+    PSendSysMessage("%u queries, batches of %u, radius %.1f, %u out of sight", queries, batchSize, radius, blocked);
+    PSendSysMessage("height: single %uus batched %uus, %u different",
+        uint32(std::chrono::duration_cast<us>(heightDone - start).count()),
+        uint32(std::chrono::duration_cast<us>(batchHeightDone - losDone).count()), heightDiffs);
+    PSendSysMessage("LoS: single %uus batched %uus, %u different",
+        uint32(std::chrono::duration_cast<us>(losDone - heightDone).count()),
+        uint32(std::chrono::duration_cast<us>(batchLosDone - batchHeightDone).count()), losDiffs);
+    return true;
+}
+
+// Compares the proc candidates lookup by walking all the aura holders with the proc flags index
+bool ChatHandler::HandleDebugProcBenchCommand(char* args)
+{
+    uint32 hits = 100000;
+    ExtractOptUInt32(&args, hits, hits);
+    if (!hits)
+        return false;
+
+    Unit* unit = getSelectedUnit();
+    if (!unit)
+        unit = m_session->GetPlayer();
+    Unit* target = unit->getVictim() ? unit->getVictim() : unit;
+
+    // Every other hit is taken
+    uint32 const procFlags[2] = { PROC_FLAG_SUCCESSFUL_MELEE_HIT, PROC_FLAG_TAKEN_MELEE_HIT };
+
+    typedef std::chrono::steady_clock Clock;
+    uint32 scanProcs = 0;
+    Clock::time_point start = Clock::now();
+    for (uint32 i = 0; i < hits; ++i)
+    {
+        bool isVictim = i & 1;
+        for (Unit::SpellAuraHolderMap::const_iterator itr = unit->GetSpellAuraHolderMap().begin(); itr != unit->GetSpellAuraHolderMap().end(); ++itr)
+        {
+            if (itr->second->IsDeleted())
+                continue;
+            SpellProcEventEntry const* spellProcEvent = nullptr;
+            if (unit->IsTriggeredAtSpellProcEvent(target, itr->second, nullptr, procFlags[isVictim], PROC_EX_NORMAL_HIT, BASE_ATTACK, isVictim, spellProcEvent))
+                ++scanProcs;
+        }
+    }
+    Clock::time_point scanDone = Clock::now();
+
+    uint32 indexProcs = 0;
+    ProcTriggeredList triggered;
+    for (uint32 i = 0; i < hits; ++i)
+    {
+        bool isVictim = i & 1;
+        unit->FillProcTriggeredList(isVictim, target, procFlags[isVictim], PROC_EX_NORMAL_HIT, BASE_ATTACK, nullptr, triggered);
+        indexProcs += triggered.size();
+        for (ProcTriggeredList::const_iterator itr = triggered.begin(); itr != triggered.end(); ++itr)
+            itr->triggeredByHolder->SetInUse(false);
+        triggered.clear();
+    }
+    Clock::time_point indexDone = Clock::now();
+
+    typedef std::chrono::microseconds us;
+    uint64 scanTime = std::max<uint64>(1, std::chrono::duration_cast<us>(scanDone - start).count());
+    uint64 indexTime = std::max<uint64>(1, std::chrono::duration_cast<us>(indexDone - scanDone).count());
+    PSendSysMessage("%s: %u hits, %u aura holders, %u may proc", unit->GetName(), hits,
+        uint32(unit->GetSpellAuraHolderMap().size()), uint32(unit->GetProcAuraHolders().size()));
+    PSendSysMessage("all holders: %u hits/s, %u procs", uint32(hits * 1000000 / scanTime), scanProcs);
+    PSendSysMessage("proc index: %u hits/s, %u procs", uint32(hits * 1000000 / indexTime), indexProcs);
+    return true;
+}
+
+namespace
+{
+    uint32 multimapNodeAllocations = 0;
+
+    // std::allocator counting the multimap tree nodes it allocates
+    template <class T>
+    struct NodeCountingAllocator
+    {
+        typedef T value_type;
+
+        NodeCountingAllocator() {}
+        template <class U> NodeCountingAllocator(NodeCountingAllocator<U> const&) {}
+
+        T* allocate(std::size_t n)
+        {
+            ++multimapNodeAllocations;
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T* p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+        template <class U> bool operator==(NodeCountingAllocator<U> const&) const { return true; }
+        template <class U> bool operator!=(NodeCountingAllocator<U> const&) const { return false; }
+    };
+
+    // The former EventProcessor storage, kept as reference for .debug eventbench
+    class MultimapEventProcessor
+    {
+        public:
+            typedef std::multimap<uint64, BasicEvent*, std::less<uint64>, NodeCountingAllocator<std::pair<uint64 const, BasicEvent*> > > EventMap;
+
+            MultimapEventProcessor() : m_time(0) {}
+
+            void Update(uint32 p_time)
+            {
+                m_time += p_time;
+                EventMap::iterator i;
+                while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+                {
+                    BasicEvent* Event = i->second;
+                    m_events.erase(i);
+                    if (Event->Execute(m_time, p_time))
+                        delete Event;
+                }
+            }
+            void AddEvent(BasicEvent* Event, uint64 e_time) { m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event)); }
+            uint64 CalculateTime(uint64 t_offset) const { return m_time + t_offset; }
+            bool HasEvents() const { return !m_events.empty(); }
+
+        private:
+            uint64 m_time;
+            EventMap m_events;
+    };
+
+    // Periodic event, like an aura or AI timer rescheduling itself
+    template <class Processor>
+    class BenchEvent : public BasicEvent
+    {
+        public:
+            BenchEvent(Processor& processor, uint32 period, uint32 repeats, uint32& executed) :
+                m_processor(processor), m_period(period), m_repeats(repeats), m_executed(executed) {}
+
+            bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+            {
+                ++m_executed;
+                if (!--m_repeats)
+                    return true;
+                m_processor.AddEvent(this, m_processor.CalculateTime(m_period));
+                return false;
+            }
+
+        private:
+            Processor& m_processor;
+            uint32 m_period;
+            uint32 m_repeats;
+            uint32& m_executed;
+    };
+
+    template <class Processor>
+    uint32 RunEventBench(uint32 objects, uint32 eventsPerObject, uint32 seed, uint32& executed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32> period(100, 3000);
+        std::uniform_int_distribution<uint32> repeats(1, 10);
+        std::vector<Processor> processors(objects);
+        for (uint32 i = 0; i < objects; ++i)
+            for (uint32 j = 0; j < eventsPerObject; ++j)
+            {
+                BasicEvent* event = new BenchEvent<Processor>(processors[i], period(rng), repeats(rng), executed);
+                processors[i].AddEvent(event, processors[i].CalculateTime(period(rng)));
+            }
+
+        uint32 ticks = 0;
+        bool pending = true;
+        while (pending)
+        {
+            pending = false;
+            for (uint32 i = 0; i < objects; ++i)
+            {
+                processors[i].Update(50);
+                pending |= processors[i].HasEvents();
+            }
+            ++ticks;
+        }
+        return ticks;
+    }
+}
+
+// Runs the same periodic events on EventProcessor and on the former multimap storage
+bool ChatHandler::HandleDebugEventBenchCommand(char* args)
+{
+    uint32 objects = 2000;
+    uint32 eventsPerObject = 8;
+    ExtractOptUInt32(&args, objects, objects);
+    ExtractOptUInt32(&args, eventsPerObject, eventsPerObject);
+    if (!objects || !eventsPerObject)
+        return false;
+
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::microseconds us;
+    uint32 mapExecuted = 0;
+    uint32 heapExecuted = 0;
+
+    // Same random periods for both runs
+    uint32 seed = urand(0, 0x7FFFFFFF);
+    multimapNodeAllocations = 0;
+    Clock::time_point start = Clock::now();
+    uint32 ticks = RunEventBench<MultimapEventProcessor>(objects, eventsPerObject, seed, mapExecuted);
+    Clock::time_point mapDone = Clock::now();
+    RunEventBench<EventProcessor>(objects, eventsPerObject, seed, heapExecuted);
+    Clock::time_point heapDone = Clock::now();
+
+    uint64 mapTime = std::max<uint64>(1, std::chrono::duration_cast<us>(mapDone - start).count());
+    uint64 heapTime = std::max<uint64>(1, std::chrono::duration_cast<us>(heapDone - mapDone).count());
+    PSendSysMessage("%u objects, %u events each, %u ticks of 50ms", objects, eventsPerObject, ticks);
+    // The heap only allocates when its vector grows, at most log2(peak events) times per object
+    PSendSysMessage("multimap: %u events in %ums, %u events/s, %u node allocations", mapExecuted, uint32(mapTime / 1000),
+        uint32(mapExecuted * 1000000 / mapTime), multimapNodeAllocations);
+    PSendSysMessage("heap: %u events in %ums, %u events/s", heapExecuted, uint32(heapTime / 1000),
+        uint32(heapExecuted * 1000000 / heapTime));
+    return true;
+}
+
+// .debug cellbench [$units [$searches [$radius]]]
+// Summons units in the player cell, then times the same unit search around the player on the
+// grid containers (Cell::VisitAllObjects) and on the cell position caches (Cell::VisitUnitsInRange).
+bool ChatHandler::HandleDebugCellBenchCommand(char* args)
+{
+    uint32 units = 500;
+    uint32 searches = 10000;
+    float radius = 10.0f;
+    ExtractOptUInt32(&args, units, units);
+    ExtractOptUInt32(&args, searches, searches);
+    if (*args && !ExtractFloat(&args, radius))
+        return false;
+    if (!searches)
+        return false;
+
+    Player* player = m_session->GetPlayer();
+    CellPair cellPair = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
+    float const cellX = (int32(cellPair.x_coord) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+    float const cellY = (int32(cellPair.y_coord) - CENTER_GRID_CELL_ID) * SIZE_OF_GRID_CELL;
+
+    std::vector<TemporarySummon*> summons;
+    for (uint32 i = 0; i < units; ++i)
+    {
+        float const x = cellX + 1.0f + rand_norm_f() * (SIZE_OF_GRID_CELL - 2.0f);
+        float const y = cellY + 1.0f + rand_norm_f() * (SIZE_OF_GRID_CELL - 2.0f);
+        if (Creature* summon = player->SummonCreature(VISUAL_WAYPOINT, x, y, player->GetPositionZ(), 0.0f, TEMPSUMMON_MANUAL_DESPAWN))
+            summons.push_back(static_cast<TemporarySummon*>(summon));
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::microseconds us;
+    std::list<Unit*> targets;
+    MaNGOS::AnyUnitInObjectRangeCheck check(player, radius);
+    MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> searcher(targets, check);
+
+    uint32 gridFound = 0;
+    Clock::time_point start = Clock::now();
+    for (uint32 i = 0; i < searches; ++i)
+    {
+        Cell::VisitAllObjects(player, searcher, radius);
+        gridFound += targets.size();
+        targets.clear();
+    }
+    Clock::time_point gridDone = Clock::now();
+
+    uint32 cacheFound = 0;
+    for (uint32 i = 0; i < searches; ++i)
+    {
+        Cell::VisitUnitsInRange(player, searcher, radius, true);
+        cacheFound += targets.size();
+        targets.clear();
+    }
+    Clock::time_point cacheDone = Clock::now();
+
+    CellPositionCache const* cache = player->GetMap()->GetCellPositionCache(Cell(cellPair));
+    PSendSysMessage("%u searches of %.1f yards, %u units in the cell", searches, radius, cache ? cache->GetCount() : 0);
+    PSendSysMessage("grid containers: %uus, %u units found", uint32(std::chrono::duration_cast<us>(gridDone - start).count()), gridFound);
+    PSendSysMessage("position caches: %uus, %u units found", uint32(std::chrono::duration_cast<us>(cacheDone - gridDone).count()), cacheFound);
+
+    for (std::vector<TemporarySummon*>::const_iterator itr = summons.begin(); itr != summons.end(); ++itr)
+        (*itr)->UnSummon();
+    return true;
+}
+
 bool ChatHandler::HandleAnticheatCommand(char* args)
 {
     Player* player = NULL;
@@ -2961,6 +3305,40 @@ bool ChatHandler::HandleInstancePerfInfosCommand(char* args)
         }
     }
     PSendSysMessage("Units in client: %u pl, %u gobj, %u crea, %u corpses", playersInClient, gobjsInClient, unitsInClient, corpsesInClient);
+    PacketCompressor::Stats compression = PacketCompressor::GetStats();
+    PSendSysMessage("Compression: " UI64FMTD " packets, " UI64FMTD " -> " UI64FMTD " bytes, " UI64FMTD " us%s",
+        compression.packets, compression.bytesIn, compression.bytesOut, compression.timeUs,
+        sWorld.getConfig(CONFIG_BOOL_COMPRESSION_DEFERRED) ? " [deferred]" : "");
+    return true;
+}
+
+bool ChatHandler::HandlePerfCommand(char* args)
+{
+    Map* map = nullptr;
+    if (*args)
+    {
+        uint32 mapId;
+        if (!ExtractUInt32(&args, mapId))
+            return false;
+        uint32 instanceId = 0;
+        ExtractOptUInt32(&args, instanceId, 0);
+        map = sMapMgr.FindMap(mapId, instanceId);
+    }
+    else if (m_session && m_session->GetPlayer())
+        map = m_session->GetPlayer()->FindMap();
+
+    if (!map)
+    {
+        SendSysMessage("Map not found. Usage: .perf [mapId [instanceId]]");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    MapTickProfiler const& profiler = map->GetTickProfiler();
+    PSendSysMessage("Map %u inst %u: %s", map->GetId(), map->GetInstanceId(), profiler.FormatCounters().c_str());
+    for (int i = 0; i < MAX_MAP_TICK_PHASES; ++i)
+        if (profiler.GetHistogram(MapTickPhase(i)).GetCount())
+            SendSysMessage(profiler.FormatPhase(MapTickPhase(i)).c_str());
     return true;
 }
 
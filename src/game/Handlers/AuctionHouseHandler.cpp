@@ -372,6 +372,8 @@ void WorldSession::HandleAuctionSellItem(WorldPacket & recv_data)
     sAuctionMgr.AddAItem(it);
     pl->MoveItemFromInventory(it->GetBagSlot(), it->GetSlot(), true);
 
+    // auction rows are keyed by auction id, this transaction writes the seller's data too
+    SqlAsyncKey asyncKey(AH->Id, pl->GetGUIDLow());
     CharacterDatabase.BeginTransaction();
     it->DeleteFromInventoryDB();
     it->SaveToDB();                                         // recursive and not have transaction guard into self, not in inventiory and can be save standalone
@@ -485,6 +487,7 @@ void WorldSession::HandleAuctionPlaceBid(WorldPacket & recv_data)
             auction_owner->GetSession()->SendAuctionOwnerNotification(auction, false);
 
         // after this update we should save player's money ...
+        SqlAsyncKey asyncKey(auction->Id);
         CharacterDatabase.PExecute("UPDATE auction SET buyguid = '%u', lastbid = '%u' WHERE id = '%u'", auction->bidder, auction->bid, auction->Id);
 
         SendAuctionCommandResult(auction, AUCTION_BID_PLACED, AUCTION_OK);
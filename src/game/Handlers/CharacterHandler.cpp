@@ -440,6 +440,8 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket & recv_data)
         return;
     }
     m_playerLoading = true;
+    // loaded after the last save of the character is written
+    SqlAsyncKey asyncKey(holder->GetGuid().GetCounter());
     CharacterDatabase.DelayQueryHolderUnsafe(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
@@ -453,6 +455,8 @@ void WorldSession::LoginPlayer(ObjectGuid loginPlayerGuid)
         return;
     }
     m_playerLoading = true;
+    // loaded after the last save of the character is written
+    SqlAsyncKey asyncKey(holder->GetGuid().GetCounter());
     CharacterDatabase.DelayQueryHolderUnsafe(&chrHandler, &CharacterHandler::HandlePlayerLoginCallback, holder);
 }
 
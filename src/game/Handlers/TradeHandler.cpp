@@ -499,6 +499,8 @@ void WorldSession::HandleAcceptTradeOpcode(WorldPacket& recvPacket)
         trader->m_trade = NULL;
 
         // desynchronized with the other saves here (SaveInventoryAndGoldToDB() not have own transaction guards)
+        // ordered with the saves of both characters
+        SqlAsyncKey asyncKey(_player->GetGUIDLow(), trader->GetGUIDLow());
         CharacterDatabase.BeginTransaction();
         _player->SaveInventoryAndGoldToDB();
         trader->SaveInventoryAndGoldToDB();
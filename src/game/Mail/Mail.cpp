@@ -252,6 +252,8 @@ void MailDraft::SendReturnToSender(uint32 sender_acc, ObjectGuid sender_guid, Ob
         needItemDelay = sender_acc != rc_account;
 
         // set owner to new receiver (to prevent delete item with sender char deleting)
+        // ordered with the writes of the receiver and with the sender ones (current key)
+        SqlAsyncKey asyncKey(receiver_guid.GetCounter(), SqlAsyncKey::GetCurrent());
         CharacterDatabase.BeginTransaction();
         for (MailItemMap::iterator mailItemIter = m_items.begin(); mailItemIter != m_items.end(); ++mailItemIter)
         {
@@ -311,6 +313,7 @@ void MailDraft::SendMailTo(MailReceiver const& receiver, MailSender const& sende
     // Add to DB
     std::string safe_subject = GetSubject();
 
+    SqlAsyncKey asyncKey(receiver.GetPlayerGuid().GetCounter(), SqlAsyncKey::GetCurrent());
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.escape_string(safe_subject);
     CharacterDatabase.PExecute("INSERT INTO mail (id,messageType,stationery,mailTemplateId,sender,receiver,subject,itemTextId,has_items,expire_time,deliver_time,money,cod,checked) "
@@ -384,6 +387,7 @@ void Mail::prepareTemplateItems(Player* receiver)
     // can be empty
     mailLoot.FillLoot(mailTemplateId, LootTemplates_Mail, receiver, true, true);
 
+    SqlAsyncKey asyncKey(receiver->GetGUIDLow(), SqlAsyncKey::GetCurrent());
     CharacterDatabase.BeginTransaction();
     CharacterDatabase.PExecute("UPDATE mail SET has_items = 1 WHERE id = %u", messageID);
 
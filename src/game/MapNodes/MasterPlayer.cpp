@@ -403,34 +403,20 @@ void MasterPlayer::LoadActions(QueryResult *result)
 
 void MasterPlayer::SaveActions()
 {
-    static SqlStatementID insertAction;
-    static SqlStatementID updateAction;
     static SqlStatementID deleteAction;
 
+    // new and changed buttons are written together, one statement for many rows
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_action (guid,button,action,type)",
+        "ON DUPLICATE KEY UPDATE action = VALUES(action), type = VALUES(type)");
+
     for (ActionButtonList::iterator itr = m_actionButtons.begin(); itr != m_actionButtons.end();)
     {
         switch (itr->second.uState)
         {
             case ACTIONBUTTON_NEW:
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insertAction, "INSERT INTO character_action (guid,button,action,type) VALUES (?, ?, ?, ?)");
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(uint32(itr->first));
-                stmt.addUInt32(itr->second.GetAction());
-                stmt.addUInt32(uint32(itr->second.GetType()));
-                stmt.Execute();
-                itr->second.uState = ACTIONBUTTON_UNCHANGED;
-                ++itr;
-            }
-            break;
             case ACTIONBUTTON_CHANGED:
             {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(updateAction, "UPDATE character_action  SET action = ?, type = ? WHERE guid = ? AND button = ?");
-                stmt.addUInt32(itr->second.GetAction());
-                stmt.addUInt32(uint32(itr->second.GetType()));
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(uint32(itr->first));
-                stmt.Execute();
+                batch.NewRow() << GetGUIDLow() << ", " << uint32(itr->first) << ", " << itr->second.GetAction() << ", " << uint32(itr->second.GetType());
                 itr->second.uState = ACTIONBUTTON_UNCHANGED;
                 ++itr;
             }
@@ -449,6 +435,7 @@ void MasterPlayer::SaveActions()
                 break;
         }
     }
+    batch.Flush();
 }
 
 
@@ -120,6 +120,10 @@ struct MANGOS_DLL_DECL Cell
     template<class T> static void VisitWorldObjects(float x, float y, Map *map, T &visitor, float radius, bool dont_load = true);
     template<class T> static void VisitAllObjects(float x, float y, Map *map, T &visitor, float radius, bool dont_load = true);
 
+    // Same units as VisitAllObjects on the loaded grids, given one by one to visitor.VisitUnit(Unit*).
+    // Units out of 'radius' of the object (with both bounding radii) are filtered on the cell position caches.
+    template<class T> static void VisitUnitsInRange(const WorldObject *obj, T &visitor, float radius, bool is3D);
+
 private:
     template<class T, class CONTAINER> void VisitCircle(TypeContainerVisitor<T, CONTAINER> &, Map &, const CellPair& , const CellPair& ) const;
 };
@@ -242,4 +242,37 @@ inline void Cell::VisitAllObjects(float x, float y, Map *map, T &visitor, float
     cell.Visit(p, wnotifier, *map, x, y, radius);
 }
 
+template<class T>
+inline void Cell::VisitUnitsInRange(const WorldObject *center_obj, T &visitor, float radius, bool is3D)
+{
+    Map* map = center_obj->GetMap();
+    float const x = center_obj->GetPositionX();
+    float const y = center_obj->GetPositionY();
+    float const z = center_obj->GetPositionZ();
+    // Searched cells limited as in Cell::Visit
+    float const range = radius + center_obj->GetObjectBoundingRadius();
+    CellPair standing_cell(MaNGOS::ComputeCellPair(x, y));
+    if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+        return;
+    CellArea area = Cell::CalculateCellArea(x, y, std::min(range, 333.0f));
+
+    auto visitUnit = [&visitor](WorldObject* obj) { visitor.VisitUnit(static_cast<Unit*>(obj)); };
+
+    // standing cell first, as Cell::Visit
+    if (CellPositionCache const* cache = map->GetCellPositionCache(Cell(standing_cell)))
+        cache->VisitInRange(x, y, z, range, is3D, TYPEMASK_UNIT, visitUnit);
+
+    for (uint32 cell_x = area.low_bound.x_coord; cell_x <= area.high_bound.x_coord; ++cell_x)
+    {
+        for (uint32 cell_y = area.low_bound.y_coord; cell_y <= area.high_bound.y_coord; ++cell_y)
+        {
+            CellPair cell_pair(cell_x, cell_y);
+            if (cell_pair == standing_cell)
+                continue;
+            if (CellPositionCache const* cache = map->GetCellPositionCache(Cell(cell_pair)))
+                cache->VisitInRange(x, y, z, range, is3D, TYPEMASK_UNIT, visitUnit);
+        }
+    }
+}
+
 #endif
@@ -0,0 +1,85 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "CellPositionCache.h"
+#include "Object.h"
+
+void CellPositionCache::Insert(WorldObject* obj)
+{
+    Remove(obj);
+
+    obj->m_positionCache = this;
+    obj->m_positionCacheIndex = m_objects.size();
+    m_x.push_back(obj->GetPositionX());
+    m_y.push_back(obj->GetPositionY());
+    m_z.push_back(obj->GetPositionZ());
+    m_radius.push_back(obj->GetObjectBoundingRadius());
+    m_typeMask.push_back(obj->m_objectType);
+    m_objects.push_back(obj);
+}
+
+void CellPositionCache::Remove(WorldObject* obj)
+{
+    if (!obj->m_positionCache)
+        return;
+
+    obj->m_positionCache->Erase(obj->m_positionCacheIndex);
+    obj->m_positionCache = nullptr;
+}
+
+void CellPositionCache::Erase(uint32 index)
+{
+    // Swap with the last unit, order does not matter
+    uint32 last = m_objects.size() - 1;
+    if (index != last)
+    {
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_z[index] = m_z[last];
+        m_radius[index] = m_radius[last];
+        m_typeMask[index] = m_typeMask[last];
+        m_objects[index] = m_objects[last];
+        m_objects[index]->m_positionCacheIndex = index;
+    }
+    m_x.pop_back();
+    m_y.pop_back();
+    m_z.pop_back();
+    m_radius.pop_back();
+    m_typeMask.pop_back();
+    m_objects.pop_back();
+}
+
+void CellPositionCache::Refresh(WorldObject const* obj)
+{
+    uint32 index = obj->m_positionCacheIndex;
+    m_x[index] = obj->GetPositionX();
+    m_y[index] = obj->GetPositionY();
+    m_z[index] = obj->GetPositionZ();
+    m_radius[index] = obj->GetObjectBoundingRadius();
+}
+
+void CellPositionCache::Clear()
+{
+    for (std::vector<WorldObject*>::const_iterator itr = m_objects.begin(); itr != m_objects.end(); ++itr)
+        (*itr)->m_positionCache = nullptr;
+
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_radius.clear();
+    m_typeMask.clear();
+    m_objects.clear();
+}
@@ -0,0 +1,102 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_CELLPOSITIONCACHE_H
+#define MANGOS_CELLPOSITIONCACHE_H
+
+#include "Common.h"
+#include "GridDefines.h"
+#include <algorithm>
+#include <vector>
+
+class WorldObject;
+
+/**
+ * Positions of the units in a cell, one packed array per field, so that range searches
+ * reject the far units without dereferencing them. The distance loop has no branch and
+ * is vectorized by the compiler, only the units it keeps are given to the search check.
+ * Units are added and removed with the cell grid containers (Map::AddToGrid/RemoveFromGrid)
+ * and refreshed by WorldObject::Relocate. Same threading rules as the grid containers.
+ */
+class CellPositionCache
+{
+    public:
+        // Like the grid references, moves the unit out of its previous cell if any
+        void Insert(WorldObject* obj);
+        // Removes the unit from its cell, if any
+        static void Remove(WorldObject* obj);
+        // Position or bounding radius changed
+        void Refresh(WorldObject const* obj);
+        // Grid unload: the units still indexed forget this cell
+        void Clear();
+
+        uint32 GetCount() const { return m_objects.size(); }
+
+        // Calls f(WorldObject*) for the objects of 'typeMask' which may be within 'range' + their
+        // bounding radius of the position. Never misses an object WorldObject::_IsWithinDist accepts.
+        // f must not add nor remove units in the cell.
+        template<class F> void VisitInRange(float x, float y, float z, float range, bool is3D, uint32 typeMask, F&& f) const;
+
+    private:
+        void Erase(uint32 index);
+
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_z;
+        std::vector<float> m_radius;
+        std::vector<uint32> m_typeMask;
+        std::vector<WorldObject*> m_objects;
+};
+
+struct GridPositionCache
+{
+    CellPositionCache cells[MAX_NUMBER_OF_CELLS][MAX_NUMBER_OF_CELLS];
+};
+
+template<class F>
+void CellPositionCache::VisitInRange(float x, float y, float z, float range, bool is3D, uint32 typeMask, F&& f) const
+{
+    uint32 const BLOCK_SIZE = 64;
+    uint8 inRange[BLOCK_SIZE];
+
+    // The exact check adds the radii in another order, do not lose a unit on rounding
+    range += 0.01f;
+    float const zFactor = is3D ? 1.0f : 0.0f;
+    uint32 const count = m_objects.size();
+    for (uint32 begin = 0; begin < count; begin += BLOCK_SIZE)
+    {
+        uint32 const size = std::min(BLOCK_SIZE, count - begin);
+        float const* px = &m_x[begin];
+        float const* py = &m_y[begin];
+        float const* pz = &m_z[begin];
+        float const* pr = &m_radius[begin];
+        uint32 const* pm = &m_typeMask[begin];
+        for (uint32 i = 0; i < size; ++i)
+        {
+            float const dx = x - px[i];
+            float const dy = y - py[i];
+            float const dz = (z - pz[i]) * zFactor;
+            float const maxDist = range + pr[i];
+            inRange[i] = uint8(dx * dx + dy * dy + dz * dz < maxDist * maxDist) & uint8((pm[i] & typeMask) != 0);
+        }
+
+        for (uint32 i = 0; i < size; ++i)
+            if (inRange[i])
+                f(m_objects[begin + i]);
+    }
+}
+
+#endif
@@ -31,6 +31,9 @@
 #include "Util.h"
 #include "SQLStorages.h"
 
+#include <ace/Mem_Map.h>
+#include <ace/OS_NS_unistd.h>
+
 char const* MAP_MAGIC         = "MAPS";
 char const* MAP_VERSION_MAGIC = "s1.3";
 char const* MAP_AREA_MAGIC    = "AREA";
@@ -40,6 +43,47 @@ char const* MAP_LIQUID_MAGIC  = "MLIQ";
 static uint16 holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
+// Reads the sections of a .map file, from the file or from its memory mapping
+class GridMapReader
+{
+    public:
+        explicit GridMapReader(FILE* file) : m_file(file), m_data(NULL), m_size(0) {}
+        GridMapReader(char* data, size_t size) : m_file(NULL), m_data(data), m_size(size) {}
+
+        bool Read(uint32 offset, void* dest, size_t size)
+        {
+            if (m_data)
+            {
+                if (offset + size > m_size)
+                    return false;
+                memcpy(dest, m_data + offset, size);
+                return true;
+            }
+            return fseek(m_file, offset, SEEK_SET) == 0 && fread(dest, size, 1, m_file) == 1;
+        }
+
+        // Points into the mapping when the array is aligned in the file, else reads a copy
+        template<class T>
+        T* GetArray(uint32 offset, uint32 count)
+        {
+            if (m_data && offset + count * sizeof(T) <= m_size && (size_t(m_data + offset) % sizeof(T)) == 0)
+                return reinterpret_cast<T*>(m_data + offset);
+
+            T* array = new T[count];
+            if (!Read(offset, array, count * sizeof(T)))
+            {
+                delete[] array;
+                return NULL;
+            }
+            return array;
+        }
+
+    private:
+        FILE* m_file;
+        char* m_data;
+        size_t m_size;
+};
+
 GridMap::GridMap()
 {
     m_flags = 0;
@@ -65,6 +109,8 @@ GridMap::GridMap()
     m_liquidFlags = NULL;
     m_liquidEntry = NULL;
     m_liquid_map  = NULL;
+
+    m_mapping = NULL;
 }
 
 GridMap::~GridMap()
@@ -72,42 +118,67 @@ GridMap::~GridMap()
     unloadData();
 }
 
-bool GridMap::loadData(char* filename)
+bool GridMap::loadData(char* filename, bool mapped)
 {
     // Unload old data if exist
     unloadData();
 
-    GridMapFileHeader header;
+    if (mapped)
+    {
+        // Not return error if file not found
+        if (ACE_OS::access(filename, R_OK) == -1)
+            return true;
+
+        m_mapping = new ACE_Mem_Map();
+        if (m_mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == 0)
+        {
+            // the mapping stays valid without the file handle
+            m_mapping->close_handle();
+            GridMapReader in(static_cast<char*>(m_mapping->addr()), m_mapping->size());
+            return loadSections(in, filename);
+        }
+
+        sLog.outError("Can't map file '%s', reading it instead.", filename);
+        delete m_mapping;
+        m_mapping = NULL;
+    }
+
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
     if (!in)
         return true;
 
-    fread(&header, sizeof(header), 1, in);
-    if (header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
+    GridMapReader reader(in);
+    bool result = loadSections(reader, filename);
+    fclose(in);
+    return result;
+}
+
+bool GridMap::loadSections(GridMapReader& in, char const* filename)
+{
+    GridMapFileHeader header;
+    if (in.Read(0, &header, sizeof(header)) &&
+            header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
             header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)))
     {
         // loadup area data
         if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
             return false;
         }
 
-		// loadup holes data
-		if (header.holesOffset && !loadHolesData(in, header.holesOffset, header.holesSize))
-		{
-			sLog.outError("Error loading map holes data\n");
-			fclose(in);
-			return false;
-		}		
+        // loadup holes data
+        if (header.holesOffset && !loadHolesData(in, header.holesOffset, header.holesSize))
+        {
+            sLog.outError("Error loading map holes data\n");
+            return false;
+        }
 
         // loadup height data
         if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
             return false;
         }
 
@@ -115,92 +186,99 @@ bool GridMap::loadData(char* filename)
         if (header.liquidMapOffset && !loadGridMapLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     sLog.outError("Map file '%s' is non-compatible version (outdated?). Please, create new using ad.exe program.", filename);
-    fclose(in);
     return false;
 }
 
+template<class T>
+void GridMap::freeArray(T*& array)
+{
+    char* data = reinterpret_cast<char*>(array);
+    char* mapped = m_mapping ? static_cast<char*>(m_mapping->addr()) : NULL;
+    if (!mapped || data < mapped || data >= mapped + m_mapping->size())
+        delete[] array;
+    array = NULL;
+}
+
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    freeArray(m_area_map);
+    freeArray(m_V9);
+    freeArray(m_V8);
+    freeArray(m_liquidEntry);
+    freeArray(m_liquidFlags);
+    freeArray(m_liquid_map);
+
+    delete m_mapping;
+    m_mapping = NULL;
 
-    m_area_map = NULL;
-    m_V9 = NULL;
-    m_V8 = NULL;
-    m_liquidEntry = NULL;
-    m_liquidFlags = NULL;
-    m_liquid_map  = NULL;
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+void GridMap::prefetch()
+{
+#ifdef MADV_WILLNEED
+    if (m_mapping)
+        m_mapping->advise(MADV_WILLNEED);
+#endif
+}
+
+bool GridMap::loadAreaData(GridMapReader& in, uint32 offset, uint32 /*size*/)
 {
     GridMapAreaHeader header;
-    fseek(in, offset, SEEK_SET);
-    fread(&header, sizeof(header), 1, in);
-    if (header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+    if (!in.Read(offset, &header, sizeof(header)) || header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
         return false;
 
     m_gridArea = header.gridArea;
     if (!(header.flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        fread(m_area_map, sizeof(uint16), 16 * 16, in);
+        m_area_map = in.GetArray<uint16>(offset + sizeof(header), 16 * 16);
+        if (!m_area_map)
+            return false;
     }
 
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(GridMapReader& in, uint32 offset, uint32 /*size*/)
 {
     GridMapHeightHeader header;
-    fseek(in, offset, SEEK_SET);
-    fread(&header, sizeof(header), 1, in);
-    if (header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+    if (!in.Read(offset, &header, sizeof(header)) || header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
         return false;
 
+    offset += sizeof(header);
     m_gridHeight = header.gridHeight;
     if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
     {
         if ((header.flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16 [129 * 129];
-            m_uint16_V8 = new uint16 [128 * 128];
-            fread(m_uint16_V9, sizeof(uint16), 129 * 129, in);
-            fread(m_uint16_V8, sizeof(uint16), 128 * 128, in);
+            m_uint16_V9 = in.GetArray<uint16>(offset, 129 * 129);
+            m_uint16_V8 = in.GetArray<uint16>(offset + 129 * 129 * sizeof(uint16), 128 * 128);
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
         else if ((header.flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8 [129 * 129];
-            m_uint8_V8 = new uint8 [128 * 128];
-            fread(m_uint8_V9, sizeof(uint8), 129 * 129, in);
-            fread(m_uint8_V8, sizeof(uint8), 128 * 128, in);
+            m_uint8_V9 = in.GetArray<uint8>(offset, 129 * 129);
+            m_uint8_V8 = in.GetArray<uint8>(offset + 129 * 129 * sizeof(uint8), 128 * 128);
             m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float [129 * 129];
-            m_V8 = new float [128 * 128];
-            fread(m_V9, sizeof(float), 129 * 129, in);
-            fread(m_V8, sizeof(float), 128 * 128, in);
+            m_V9 = in.GetArray<float>(offset, 129 * 129);
+            m_V8 = in.GetArray<float>(offset + 129 * 129 * sizeof(float), 128 * 128);
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
+
+        if (!m_V9 || !m_V8)
+            return false;
     }
     else
         m_gridGetHeight = &GridMap::getHeightFromFlat;
@@ -208,24 +286,18 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 size)
+bool GridMap::loadHolesData(GridMapReader& in, uint32 offset, uint32 /*size*/)
 {
-	if (fseek(in, offset, SEEK_SET) != 0)
-		return false;
-
-	if (fread(&m_holes, sizeof(m_holes), 1, in) != 1)
-		return false;
-	return true;
+    return in.Read(offset, &m_holes, sizeof(m_holes));
 }
 
-bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadGridMapLiquidData(GridMapReader& in, uint32 offset, uint32 /*size*/)
 {
     GridMapLiquidHeader header;
-    fseek(in, offset, SEEK_SET);
-    fread(&header, sizeof(header), 1, in);
-    if (header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+    if (!in.Read(offset, &header, sizeof(header)) || header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
         return false;
 
+    offset += sizeof(header);
     m_liquidType    = header.liquidType;
     m_liquid_offX   = header.offsetX;
     m_liquid_offY   = header.offsetY;
@@ -235,17 +307,21 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
 
     if (!(header.flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        fread(m_liquidEntry, sizeof(uint16), 16 * 16, in);
+        m_liquidEntry = in.GetArray<uint16>(offset, 16 * 16);
+        offset += 16 * 16 * sizeof(uint16);
 
-        m_liquidFlags = new uint8[16 * 16];
-        fread(m_liquidFlags, sizeof(uint8), 16 * 16, in);
+        m_liquidFlags = in.GetArray<uint8>(offset, 16 * 16);
+        offset += 16 * 16 * sizeof(uint8);
+
+        if (!m_liquidEntry || !m_liquidFlags)
+            return false;
     }
 
     if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float [m_liquid_width * m_liquid_height];
-        fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in);
+        m_liquid_map = in.GetArray<float>(offset, m_liquid_width * m_liquid_height);
+        if (!m_liquid_map)
+            return false;
     }
 
     return true;
@@ -1165,6 +1241,17 @@ GridMap* TerrainInfo::GetGrid(const float x, const float y)
     return pMap;
 }
 
+void TerrainInfo::Prefetch(float x, float y)
+{
+    int gx = (int)(32 - x / SIZE_OF_GRIDS);
+    int gy = (int)(32 - y / SIZE_OF_GRIDS);
+
+    for (int i = std::max(gx - 1, 0); i <= std::min(gx + 1, MAX_NUMBER_OF_GRIDS - 1); ++i)
+        for (int j = std::max(gy - 1, 0); j <= std::min(gy + 1, MAX_NUMBER_OF_GRIDS - 1); ++j)
+            if (GridMap* pMap = m_GridMaps[i][j])
+                pMap->prefetch();
+}
+
 GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 {
     // double checked lock pattern
@@ -1181,7 +1268,7 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
             char* tmp = new char[len];
             snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
 
-            if (!map->loadData(tmp))
+            if (!map->loadData(tmp, sWorld.getConfig(CONFIG_BOOL_TERRAIN_MEMORY_MAPPED)))
             {
                 sLog.outError("Error load map file: \n %s\n", tmp);
                 // ASSERT(false);
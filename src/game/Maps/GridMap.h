@@ -36,6 +36,10 @@ class InstanceData;
 class Group;
 class BattleGround;
 class Map;
+class GridMapReader;
+ACE_BEGIN_VERSIONED_NAMESPACE_DECL
+class ACE_Mem_Map;
+ACE_END_VERSIONED_NAMESPACE_DECL
 
 struct GridMapFileHeader
 {
@@ -154,11 +158,17 @@ class GridMap
         uint8* m_liquidFlags;
         float* m_liquid_map;
 
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
-		bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        // Mapping of the .map file when loaded memory mapped, the arrays above then point into it
+        ACE_Mem_Map* m_mapping;
+
+        bool loadSections(GridMapReader& in, char const* filename);
+        bool loadAreaData(GridMapReader& in, uint32 offset, uint32 size);
+        bool loadHeightData(GridMapReader& in, uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(GridMapReader& in, uint32 offset, uint32 size);
+        bool loadHolesData(GridMapReader& in, uint32 offset, uint32 size);
 		bool isHole(int row, int col) const;
+        // Frees an array, unless it points into the mapping
+        template<class T> void freeArray(T*& array);
 
         // Get height functions and pointers
         typedef float(GridMap::*pGetHeightPtr)(float x, float y) const;
@@ -173,8 +183,12 @@ class GridMap
         GridMap();
         ~GridMap();
 
-        bool loadData(char* filaname);
+        // 'mapped': maps the file read-only instead of copying it, pages are then read from disk
+        // on first use and shared with the other processes using the same file
+        bool loadData(char* filaname, bool mapped = false);
         void unloadData();
+        // Asks the system to read the pages of a mapped file ahead of their use
+        void prefetch();
 
         static bool ExistMap(uint32 mapid, int gx, int gy);
         static bool ExistVMap(uint32 mapid, int gx, int gy);
@@ -242,6 +256,9 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<AtomicLong>
         bool GetAreaInfo(float x, float y, float z, uint32& mogpflags, int32& adtId, int32& rootId, int32& groupId) const;
         bool IsOutdoors(float x, float y, float z) const;
 
+        // Prefetches the memory mapped terrain of the grid at x,y and of the loaded grids around it
+        void Prefetch(float x, float y);
+
 
         void LoadAll();
         // this method should be used only by TerrainManager
@@ -40,6 +40,32 @@ VisibleChangesNotifier::Visit(CameraMapType &m)
         iter->getSource()->UpdateVisibilityOf(&i_object);
 }
 
+void
+VisibleNotifier::SetIncremental(float prevX, float prevY, float nearDist, float farDist)
+{
+    i_incremental = true;
+    i_prevX = prevX;
+    i_prevY = prevY;
+    i_curX = i_camera.GetBody()->GetPositionX();
+    i_curY = i_camera.GetBody()->GetPositionY();
+    i_nearDistSq = nearDist * nearDist;
+    i_farDistSq = farDist * farDist;
+}
+
+bool
+VisibleNotifier::IsUnchanged(WorldObject const* obj) const
+{
+    float dx = obj->GetPositionX() - i_prevX;
+    float dy = obj->GetPositionY() - i_prevY;
+    float prevDistSq = dx * dx + dy * dy;
+    if (prevDistSq <= i_nearDistSq || prevDistSq >= i_farDistSq)
+        return false;
+    dx = obj->GetPositionX() - i_curX;
+    dy = obj->GetPositionY() - i_curY;
+    float curDistSq = dx * dx + dy * dy;
+    return curDistSq > i_nearDistSq && curDistSq < i_farDistSq;
+}
+
 void
 VisibleNotifier::Notify()
 {
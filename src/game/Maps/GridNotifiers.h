@@ -44,12 +44,33 @@ namespace MaNGOS
         ObjectGuidSet i_clientGUIDs;
         std::set<WorldObject*> i_visibleNow;
 
-        explicit VisibleNotifier(Camera &c) : i_camera(c), i_clientGUIDs(c.GetOwner()->m_visibleGUIDs) {}
+        // Incremental update: objects in the ring [near, far] around both the previous
+        // and the current view point position can not change state, and are not checked.
+        bool i_incremental;
+        float i_prevX, i_prevY;
+        float i_curX, i_curY;
+        float i_nearDistSq, i_farDistSq;
+
+        explicit VisibleNotifier(Camera &c) : i_camera(c), i_clientGUIDs(c.GetOwner()->m_visibleGUIDs), i_incremental(false),
+            i_prevX(0.0f), i_prevY(0.0f), i_curX(0.0f), i_curY(0.0f), i_nearDistSq(0.0f), i_farDistSq(0.0f) {}
+        void SetIncremental(float prevX, float prevY, float nearDist, float farDist);
+        bool IsUnchanged(WorldObject const* obj) const;
         template<class T> void Visit(GridRefManager<T> &m);
         void Visit(CameraMapType&) {}
         void Notify(void);
     };
 
+    // Compares the client visible list with what a full visibility update would give
+    struct MANGOS_DLL_DECL VisibilityConsistencyChecker
+    {
+        Camera& i_camera;
+        uint32 i_errors;
+
+        explicit VisibilityConsistencyChecker(Camera &c) : i_camera(c), i_errors(0) {}
+        template<class T> void Visit(GridRefManager<T> &m);
+        void Visit(CameraMapType&) {}
+    };
+
     struct MANGOS_DLL_DECL VisibleChangesNotifier
     {
         WorldObject &i_object;
@@ -342,6 +363,7 @@ namespace MaNGOS
 
         void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &m);
+        void VisitUnit(Unit* u) { if (i_check(u)) i_object = u; }
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
@@ -357,6 +379,7 @@ namespace MaNGOS
 
         void Visit(PlayerMapType &m);
         void Visit(CreatureMapType &m);
+        void VisitUnit(Unit* u) { if (i_check(u)) i_objects.push_back(u); }
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) {}
     };
@@ -30,17 +30,42 @@
 #include "DBCStores.h"
 #include "DBCEnums.h"
 #include "SpellMgr.h"
+#include "Log.h"
 
 template<class T>
 inline void MaNGOS::VisibleNotifier::Visit(GridRefManager<T> &m)
 {
     for(typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
-        i_camera.UpdateVisibilityOf(iter->getSource(), i_data, i_visibleNow);
+        if (!i_incremental || !IsUnchanged(iter->getSource()))
+            i_camera.UpdateVisibilityOf(iter->getSource(), i_data, i_visibleNow);
         i_clientGUIDs.erase(iter->getSource()->GetObjectGuid());
     }
 }
 
+template<class T>
+inline void MaNGOS::VisibilityConsistencyChecker::Visit(GridRefManager<T> &m)
+{
+    Player* player = i_camera.GetOwner();
+    WorldObject const* viewPoint = i_camera.GetBody();
+    for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+    {
+        T* target = iter->getSource();
+        // Transports are never in the visible list
+        if (target->GetTypeId() == TYPEID_GAMEOBJECT && ((GameObject*)target)->IsTransport())
+            continue;
+
+        bool visible = player->IsInVisibleList(target);
+        bool expected = target->FindMap() && target->isWithinVisibilityDistanceOf(player, viewPoint, visible) && target->isVisibleForInState(player, viewPoint, visible);
+        if (visible != expected)
+        {
+            ++i_errors;
+            sLog.outError("Visibility check: %s is %svisible for %s (distance %f), should be the opposite",
+                target->GetGuidStr().c_str(), visible ? "" : "not ", player->GetGuidStr().c_str(), viewPoint->GetDistance2d(target));
+        }
+    }
+}
+
 inline void MaNGOS::ObjectUpdater::Visit(CreatureMapType &m)
 {
     std::vector<Creature*> creaturesToUpdate;
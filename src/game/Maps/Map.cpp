@@ -48,6 +48,10 @@
 #include "PlayerBroadcaster.h"
 #include "GridSearchers.h"
 
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
 #define MAX_GRID_LOAD_TIME      50
 
 Map::~Map()
@@ -104,6 +108,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
             //z code
             m_bLoadedGrids[idx][j] = false;
             setNGrid(NULL, idx, j);
+            i_positionCaches[idx][j] = NULL;
         }
     }
 
@@ -174,6 +179,7 @@ template<>
 void Map::AddToGrid(Player* obj, NGridType *grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).AddWorldObject(obj);
+    GetCellPositionCache(cell)->Insert(obj);
 }
 
 template<>
@@ -202,6 +208,7 @@ void Map::AddToGrid(Creature* obj, NGridType *grid, Cell const& cell)
         (*grid)(cell.CellX(), cell.CellY()).AddGridObject<Creature>(obj);
         obj->SetCurrentCell(cell);
     }
+    GetCellPositionCache(cell)->Insert(obj);
 }
 
 template<class T>
@@ -214,6 +221,7 @@ template<>
 void Map::RemoveFromGrid(Player* obj, NGridType *grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).RemoveWorldObject(obj);
+    CellPositionCache::Remove(obj);
 }
 
 template<>
@@ -236,6 +244,7 @@ void Map::RemoveFromGrid(Creature* obj, NGridType *grid, Cell const& cell)
     // remove from grid object store
     else
         (*grid)(cell.CellX(), cell.CellY()).RemoveGridObject<Creature>(obj);
+    CellPositionCache::Remove(obj);
 }
 
 void Map::DeleteFromWorld(Player* player)
@@ -251,6 +260,7 @@ Map::EnsureGridCreated(const GridPair &p)
     {
         setNGrid(new NGridType(p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord, p.x_coord, p.y_coord, i_gridExpiry, sWorld.getConfig(CONFIG_BOOL_GRID_UNLOAD)),
                  p.x_coord, p.y_coord);
+        i_positionCaches[p.x_coord][p.y_coord] = new GridPositionCache;
 
         // build a linkage between this map and NGridType
         buildNGridLinkage(getNGrid(p.x_coord, p.y_coord));
@@ -592,6 +602,7 @@ inline void Map::UpdateCellsAroundObject(uint32 now, uint32 diff, WorldObject co
             if (!isCellMarked(cell_id))
             {
                 markCell(cell_id);
+                m_tickProfiler.AddCounter(MAP_COUNTER_CELLS_VISITED, 1);
                 CellPair pair(x, y);
                 Cell cell(pair);
                 cell.SetNoCreate();
@@ -614,61 +625,195 @@ inline void Map::MarkCellsAroundObject(WorldObject const* object)
         for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
         {
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
+            if (isCellMarked(cell_id))
+                continue;
             markCell(cell_id);
+            m_markedCellsList.push_back(cell_id);
         }
     }
 }
 
 
-inline void Map::UpdateActiveCellsCallback(uint32 diff, uint32 now, uint32 threadId, uint32 totalThreads, uint32 step)
+inline void Map::UpdateActiveCellsCallback(uint32 diff, uint32 now, std::vector<uint32> const& cells)
 {
     MaNGOS::ObjectUpdater updater(diff, now);
     TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    int safeDistCells = sWorld.getConfig(CONFIG_UINT32_MTCELLS_SAFEDISTANCE) / SIZE_OF_GRID_CELL + 1;
-    totalThreads *= 2;
-    threadId = 2 * threadId + step;
-    for (int y = 0; y < TOTAL_NUMBER_OF_CELLS_PER_MAP; ++y)
+    for (std::vector<uint32>::const_iterator it = cells.begin(); it != cells.end(); ++it)
     {
-        // Skip grids not for this thread
-        if ((y / safeDistCells) % totalThreads != threadId)
-            continue;
-        for (int x = 0; x < TOTAL_NUMBER_OF_CELLS_PER_MAP; ++x)
-        {
-            uint32 cellId = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-            if (!isCellMarked(cellId))
-                continue;
-            CellPair pair(x, y);
-            Cell cell(pair);
-            cell.SetNoCreate();
-            Visit(cell, grid_object_update);
-            Visit(cell, world_object_update);
-        }
+        CellPair pair(*it % TOTAL_NUMBER_OF_CELLS_PER_MAP, *it / TOTAL_NUMBER_OF_CELLS_PER_MAP);
+        Cell cell(pair);
+        cell.SetNoCreate();
+        Visit(cell, grid_object_update);
+        Visit(cell, world_object_update);
     }
 }
 
-class MapAsynchCellsWorker : public ACE_Based::Runnable
+/**
+ * Marked cells are grouped in square shards of MTCells.SafeDistance. Objects of two
+ * shards which are not neighbours are at least at this distance, so these shards can
+ * be updated at the same time. Workers take the heaviest shard (by objects count)
+ * whose neighbours are not being updated: no barrier, and a busy area gets a thread
+ * as soon as possible instead of serializing its whole stripe of the map.
+ * Workers are short pool tasks and never wait: a worker finding only shards next to
+ * running ones stops, and the worker releasing a shard posts new workers for the
+ * shards it unblocked.
+ */
+class CellsUpdateScheduler
 {
-public:
-    MapAsynchCellsWorker(int i, int nthreads, uint32 _diff, uint32 _now, uint32 _step, Map* m) : threadIdx(i), nThreads(nthreads), now(_now), diff(_diff), map(m), step(_step)
-    {
-    }
+    public:
+        struct Shard
+        {
+            Shard(uint32 _x, uint32 _y) : x(_x), y(_y), weight(0), runningNeighbours(0) {}
+            uint32 x;
+            uint32 y;
+            uint32 weight;
+            std::vector<uint32> cells;
+            std::vector<uint32> neighbours;
+            uint32 runningNeighbours;
+        };
+
+        struct WorkerStats
+        {
+            WorkerStats() : busyTime(0), maxShardTime(0) {}
+            uint64 busyTime;
+            uint64 maxShardTime;
+        };
 
-    virtual void run()
-    {
-        map->UpdateActiveCellsCallback(diff, now, threadIdx, nThreads, step);
-    }
-    int threadIdx;
-    int nThreads;
-    uint32 diff, now, step;
-    Map* map;
-};
+        CellsUpdateScheduler(Map& map, uint32 diff, uint32 now) : m_map(map), m_diff(diff), m_now(now), m_group(nullptr), m_stats(nullptr) {}
+
+        void Build(std::vector<uint32> const& markedCells, uint32 shardSize, NGridType* const grids[][MAX_NUMBER_OF_GRIDS])
+        {
+            std::unordered_map<uint32, uint32> shardIndex;
+            for (std::vector<uint32>::const_iterator it = markedCells.begin(); it != markedCells.end(); ++it)
+            {
+                uint32 x = *it % TOTAL_NUMBER_OF_CELLS_PER_MAP;
+                uint32 y = *it / TOTAL_NUMBER_OF_CELLS_PER_MAP;
+                uint32 key = ((x / shardSize) << 16) | (y / shardSize);
+                std::unordered_map<uint32, uint32>::iterator shardIt = shardIndex.find(key);
+                if (shardIt == shardIndex.end())
+                {
+                    shardIt = shardIndex.insert(std::make_pair(key, uint32(m_shards.size()))).first;
+                    m_shards.push_back(Shard(x / shardSize, y / shardSize));
+                }
+                Shard& shard = m_shards[shardIt->second];
+                shard.cells.push_back(*it);
+                // Visiting an empty cell costs something too
+                ++shard.weight;
+                if (NGridType* grid = grids[x / MAX_NUMBER_OF_CELLS][y / MAX_NUMBER_OF_CELLS])
+                    shard.weight += grid->ObjectsInCell(x % MAX_NUMBER_OF_CELLS, y % MAX_NUMBER_OF_CELLS);
+            }
+
+            // Conflict graph
+            for (uint32 i = 0; i < m_shards.size(); ++i)
+            {
+                Shard& shard = m_shards[i];
+                std::sort(shard.cells.begin(), shard.cells.end());
+                for (int dx = -1; dx <= 1; ++dx)
+                    for (int dy = -1; dy <= 1; ++dy)
+                    {
+                        if ((!dx && !dy) || (!shard.x && dx < 0) || (!shard.y && dy < 0))
+                            continue;
+                        std::unordered_map<uint32, uint32>::const_iterator n = shardIndex.find(((shard.x + dx) << 16) | (shard.y + dy));
+                        if (n != shardIndex.end())
+                            shard.neighbours.push_back(n->second);
+                    }
+                m_pending.push_back(i);
+            }
+            std::sort(m_pending.begin(), m_pending.end(), [this](uint32 a, uint32 b) { return m_shards[a].weight > m_shards[b].weight; });
+        }
+
+        // Updates every shard with up to stats.size() workers, the calling thread being one of them.
+        // Returns once the calling worker has nothing left to take, 'group' waits for the others.
+        void Run(ThreadPool::TaskGroup& group, std::vector<WorkerStats>& stats)
+        {
+            m_group = &group;
+            m_stats = &stats;
+            for (uint32 slot = 0; slot < (stats.size() - 1); ++slot)
+                m_group->Run([this, slot]() { Work(slot); });
+            Work(stats.size() - 1);
+        }
 
+        uint32 GetShardCount() const { return m_shards.size(); }
+
+    private:
+        // Updates shards until none can be taken. 'slot' is the worker stats index.
+        void Work(uint32 slot)
+        {
+            WorkerStats& stats = (*m_stats)[slot];
+            while (Shard* shard = Acquire(slot))
+            {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                m_map.UpdateActiveCellsCallback(m_diff, m_now, shard->cells);
+                uint64 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+                stats.busyTime += elapsed;
+                stats.maxShardTime = std::max(stats.maxShardTime, elapsed);
+                Release(shard);
+            }
+        }
+
+        // Returns nullptr, and frees the worker slot, if every pending shard is next to a running one
+        Shard* Acquire(uint32 slot)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            for (std::vector<uint32>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+            {
+                Shard& shard = m_shards[*it];
+                if (shard.runningNeighbours)
+                    continue;
+                for (std::vector<uint32>::const_iterator n = shard.neighbours.begin(); n != shard.neighbours.end(); ++n)
+                    ++m_shards[*n].runningNeighbours;
+                m_pending.erase(it);
+                return &shard;
+            }
+            m_idleSlots.push_back(slot);
+            return nullptr;
+        }
+
+        void Release(Shard* shard)
+        {
+            std::vector<uint32> slots;
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                for (std::vector<uint32>::const_iterator n = shard->neighbours.begin(); n != shard->neighbours.end(); ++n)
+                    --m_shards[*n].runningNeighbours;
+
+                // The releasing worker takes one of the free shards, idle slots get the others
+                uint32 available = 0;
+                for (std::vector<uint32>::const_iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+                    if (!m_shards[*it].runningNeighbours)
+                        ++available;
+                while (available > 1 && !m_idleSlots.empty())
+                {
+                    slots.push_back(m_idleSlots.back());
+                    m_idleSlots.pop_back();
+                    --available;
+                }
+            }
+            for (std::vector<uint32>::const_iterator it = slots.begin(); it != slots.end(); ++it)
+            {
+                uint32 slot = *it;
+                m_group->Run([this, slot]() { Work(slot); });
+            }
+        }
+
+        Map& m_map;
+        uint32 m_diff;
+        uint32 m_now;
+        std::vector<Shard> m_shards;
+        std::vector<uint32> m_pending;                      // heaviest first
+        std::mutex m_lock;
+        std::vector<uint32> m_idleSlots;                    // stats index of the stopped workers
+        ThreadPool::TaskGroup* m_group;
+        std::vector<WorkerStats>* m_stats;
+};
 
 inline void Map::UpdateActiveCellsAsynch(uint32 now, uint32 diff)
 {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     resetMarkedCells();
+    m_markedCellsList.clear();
 
     // Mark all cells that need update
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -677,27 +822,42 @@ inline void Map::UpdateActiveCellsAsynch(uint32 now, uint32 diff)
     for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end(); ++m_activeNonPlayersIter)
         MarkCellsAroundObject(*m_activeNonPlayersIter);
 
-    const int nthreads = sWorld.getConfig(CONFIG_UINT32_MTCELLS_THREADS);
-    // Step 1
-    std::vector<ACE_Based::Thread*> threads;
-    for (int i = 0; i < (nthreads - 1); ++i)
-        threads.push_back(new ACE_Based::Thread(new MapAsynchCellsWorker(i, nthreads, diff, now, 0, this)));
-    UpdateActiveCellsCallback(diff, now, nthreads-1, nthreads, 0);
-    for (int i = 0; i < threads.size(); ++i)
+    uint32 shardSize = sWorld.getConfig(CONFIG_UINT32_MTCELLS_SAFEDISTANCE) / SIZE_OF_GRID_CELL + 1;
+    CellsUpdateScheduler scheduler(*this, diff, now);
+    scheduler.Build(m_markedCellsList, shardSize, i_grids);
+
+    uint32 nthreads = std::min(sWorld.getConfig(CONFIG_UINT32_MTCELLS_THREADS), scheduler.GetShardCount());
+    if (!nthreads)
+        nthreads = 1;
+    std::vector<CellsUpdateScheduler::WorkerStats> stats(nthreads);
     {
-        threads[i]->wait();
-        delete threads[i];
+        ThreadPool::TaskGroup cellsGroup(sMapMgr.GetUpdatePool());
+        scheduler.Run(cellsGroup, stats);
+        cellsGroup.Wait();
     }
-    // Step 2
-    threads.clear();
-    for (int i = 0; i < (nthreads - 1); ++i)
-        threads.push_back(new ACE_Based::Thread(new MapAsynchCellsWorker(i, nthreads, diff, now, 1, this)));
-    UpdateActiveCellsCallback(diff, now, nthreads-1, nthreads, 1);
-    for (int i = 0; i < threads.size(); ++i)
+
+    // Imbalance: busiest thread against the average one
+    uint64 totalBusy = 0;
+    m_cellsUpdateStats.maxBusyTime = 0;
+    m_cellsUpdateStats.maxShardTime = 0;
+    for (std::vector<CellsUpdateScheduler::WorkerStats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
     {
-        threads[i]->wait();
-        delete threads[i];
+        totalBusy += it->busyTime;
+        m_cellsUpdateStats.maxBusyTime = std::max(m_cellsUpdateStats.maxBusyTime, uint32(it->busyTime));
+        m_cellsUpdateStats.maxShardTime = std::max(m_cellsUpdateStats.maxShardTime, uint32(it->maxShardTime));
     }
+    m_cellsUpdateStats.shards = scheduler.GetShardCount();
+    m_cellsUpdateStats.cells = m_markedCellsList.size();
+    m_tickProfiler.AddCounter(MAP_COUNTER_CELLS_VISITED, m_markedCellsList.size());
+    m_cellsUpdateStats.threads = nthreads;
+    m_cellsUpdateStats.avgBusyTime = uint32(totalBusy / nthreads);
+    m_cellsUpdateStats.wallTime = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+    uint32 slowUpdate = sWorld.getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_UPDATE);
+    if (slowUpdate && m_cellsUpdateStats.wallTime > slowUpdate * IN_MILLISECONDS)
+        sLog.out(LOG_PERFORMANCE, "Map %u cells update: %4ums [%u cells, %u shards, %u threads] busy max %ums avg %ums, biggest shard %ums",
+            GetId(), m_cellsUpdateStats.wallTime / IN_MILLISECONDS, m_cellsUpdateStats.cells, m_cellsUpdateStats.shards, nthreads,
+            m_cellsUpdateStats.maxBusyTime / IN_MILLISECONDS, m_cellsUpdateStats.avgBusyTime / IN_MILLISECONDS, m_cellsUpdateStats.maxShardTime / IN_MILLISECONDS);
 }
 
 inline void Map::UpdateActiveCellsSynch(uint32 now, uint32 diff)
@@ -724,27 +884,6 @@ inline void Map::UpdateActiveCellsSynch(uint32 now, uint32 diff)
     }
 }
 
-class UnitsMovementUpdater : public ACE_Based::Runnable
-{
-public:
-    UnitsMovementUpdater(int i, int nthreads, std::set<Unit*>& _updates, uint32 _diff) : threadIdx(i), nThreads(nthreads), updates(_updates), diff(_diff)
-    {
-    }
-
-    virtual void run()
-    {
-        int i = 0;
-        for (std::set<Unit*>::iterator iter = updates.begin(); iter != updates.end(); ++iter)
-            if (((++i) % nThreads) == threadIdx)
-                if ((*iter)->IsInWorld())
-                    (*iter)->GetMotionMaster()->UpdateMotionAsync(diff);
-    }
-    int threadIdx;
-    int nThreads;
-    std::set<Unit*>& updates;
-    uint32 diff;
-};
-
 inline void Map::UpdateCells(uint32 map_diff)
 {
     uint32 now = WorldTimer::getMSTime();
@@ -760,16 +899,23 @@ inline void Map::UpdateCells(uint32 map_diff)
         UpdateActiveCellsSynch(now, diff);
 
     int nthreads = sWorld.getConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS);
-    if (IsContinent() && nthreads)
+    if (IsContinent() && nthreads && !unitsMvtUpdate.empty())
     {
-        std::vector<ACE_Based::Thread*> threads;
-        for (int i = 0; i < nthreads; ++i)
-            threads.push_back(new ACE_Based::Thread(new UnitsMovementUpdater(i, nthreads, unitsMvtUpdate, diff)));
-        for (int i = 0; i < threads.size(); ++i)
+        // Split the set once, instead of having every task walk all of it
+        std::vector<Unit*> units(unitsMvtUpdate.begin(), unitsMvtUpdate.end());
+        std::size_t step = units.size() / nthreads + 1;
+        ThreadPool::TaskGroup motionGroup(sMapMgr.GetUpdatePool());
+        for (std::size_t begin = 0; begin < units.size(); begin += step)
         {
-            threads[i]->wait();
-            delete threads[i];
+            std::size_t end = std::min(begin + step, units.size());
+            motionGroup.Run([&units, begin, end, diff]()
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                    if (units[i]->IsInWorld())
+                        units[i]->GetMotionMaster()->UpdateMotionAsync(diff);
+            });
         }
+        motionGroup.Wait();
     }
     unitsMvtUpdate.clear();
 }
@@ -808,6 +954,20 @@ void Map::UpdateSessionsMovementAndSpellsIfNeeded()
     m_lastMvtSpellsUpdate = WorldTimer::getMSTime();
 }
 
+uint32 Map::GetNextPeriodicUpdateDelay() const
+{
+    uint32 now = WorldTimer::getMSTime();
+    uint32 packetsDiff = WorldTimer::getMSTimeDiff(m_lastMvtSpellsUpdate, now);
+    uint32 playersDiff = WorldTimer::getMSTimeDiff(_lastPlayersUpdate, now);
+    uint32 packetsPeriod = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_UPDATE_PACKETS_DIFF);
+    uint32 playersPeriod = sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_UPDATE_PLAYERS_DIFF);
+
+    uint32 delay = std::min(packetsDiff < packetsPeriod ? packetsPeriod - packetsDiff : 0,
+                            playersDiff < playersPeriod ? playersPeriod - playersDiff : 0);
+    // Never spin
+    return std::max(delay, 1u);
+}
+
 void Map::UpdatePlayers()
 {
     uint32 now = WorldTimer::getMSTime();
@@ -855,6 +1015,7 @@ void Map::Update(uint32 t_diff)
 {
     uint32 updateMapTime = WorldTimer::getMSTime();
     uint32 timeDiff = 0;
+    m_tickProfiler.BeginTick();
     _dynamicTree.update(t_diff);
 
     ProcessSessionPackets(PACKET_PROCESS_DB_QUERY); // TODO: Move somewhere else ?
@@ -872,25 +1033,35 @@ void Map::Update(uint32 t_diff)
         }
     }
     uint32 sessionsUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime);
+    m_tickProfiler.EndPhase(MAP_TICK_SESSIONS);
 
     /// update players at tick
     UpdateSessionsMovementAndSpellsIfNeeded();
     UpdatePlayers();
     uint32 playersUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - sessionsUpdateTime;
+    m_tickProfiler.EndPhase(MAP_TICK_PLAYERS);
 
     UpdateCells(t_diff);
     uint32 activeCellsUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - playersUpdateTime - sessionsUpdateTime;
+    m_tickProfiler.EndPhase(MAP_TICK_CELLS);
+
+    // Paths requested by the moves of this tick are computed while we send the updates
+    m_pathRequests.StartComputations(this);
 
     // Send world objects and item update field changes
     SendObjectUpdates();
+    m_pathRequests.WaitComputations();
     uint32 objectsUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - activeCellsUpdateTime - playersUpdateTime - sessionsUpdateTime;
+    m_tickProfiler.EndPhase(MAP_TICK_SEND_OBJ_UPDATES);
 
     UpdateVisibilityForRelocations();
     uint32 visibilityUpdateTime = WorldTimer::getMSTimeDiffToNow(updateMapTime) - objectsUpdateTime - activeCellsUpdateTime - playersUpdateTime - sessionsUpdateTime;
+    m_tickProfiler.EndPhase(MAP_TICK_RELOCATIONS);
 
     UpdateSessionsMovementAndSpellsIfNeeded();
     UpdatePlayers();
     uint32 playersUpdateTime2 = WorldTimer::getMSTimeDiffToNow(updateMapTime) - objectsUpdateTime - activeCellsUpdateTime - playersUpdateTime - sessionsUpdateTime - visibilityUpdateTime;
+    m_tickProfiler.EndPhase(MAP_TICK_PLAYERS2);
 
     updateMapTime = WorldTimer::getMSTimeDiffToNow(updateMapTime);
 
@@ -899,18 +1070,17 @@ void Map::Update(uint32 t_diff)
     if (_updateIdx >= 0)
     {
         additionnalWaitTime = WorldTimer::getMSTime();
-        sMapMgr.MarkContinentUpdateFinished(_updateIdx);
-        while (!sMapMgr.IsContinentUpdateFinished())
+        sMapMgr.MarkContinentUpdateFinished();
+        // Use the slack while the other continents finish: sleep until packets or players
+        // are due for an update, and leave as soon as the last continent is done.
+        while (!sMapMgr.WaitContinentsUpdate(GetNextPeriodicUpdateDelay()))
         {
-            ACE_Based::Thread::Sleep(10);
-            if (sMapMgr.IsContinentUpdateFinished())
-                break;
-
             UpdateSessionsMovementAndSpellsIfNeeded();
             UpdatePlayers();
             ++additionnalUpdateCounts;
         }
         additionnalWaitTime = WorldTimer::getMSTimeDiffToNow(additionnalWaitTime);
+        m_tickProfiler.EndPhase(MAP_TICK_WAIT);
     }
     // Don't unload grids if it's battleground, since we may have manually added GOs,creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
@@ -931,6 +1101,8 @@ void Map::Update(uint32 t_diff)
 
     if (i_data)
         i_data->Update(t_diff);
+    m_tickProfiler.EndPhase(MAP_TICK_GRIDS_SCRIPTS);
+    m_tickProfiler.EndTick();
 
     bool packetBroadcastSlow = sWorld.GetBroadcaster()->IsMapSlow(GetInstanceId());
     if (sWorld.getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_UPDATE) && updateMapTime > sWorld.getConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_UPDATE))
@@ -1146,7 +1318,11 @@ Map::PlayerRelocation(Player *player, float x, float y, float z, float orientati
         if (!old_cell.DiffGrid(new_cell))
             AddToGrid(player, oldGrid, new_cell);
         else
+        {
             EnsureGridLoadedAtEnter(new_cell, player);
+            if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_PREFETCH))
+                m_TerrainData->Prefetch(x, y);
+        }
 
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         player->GetViewPoint().Event_GridChanged(&(*newGrid)(new_cell.CellX(), new_cell.CellY()));
@@ -1183,7 +1359,11 @@ void Map::DoPlayerGridRelocation(Player *player, float x, float y, float z, floa
         if (!old_cell.DiffGrid(new_cell))
             AddToGrid(player, oldGrid, new_cell);
         else
+        {
             EnsureGridLoadedAtEnter(new_cell, player);
+            if (sWorld.getConfig(CONFIG_BOOL_TERRAIN_PREFETCH))
+                m_TerrainData->Prefetch(x, y);
+        }
 
         NGridType* newGrid = getNGrid(new_cell.GridX(), new_cell.GridY());
         player->GetViewPoint().Event_GridChanged(&(*newGrid)(new_cell.CellX(), new_cell.CellY()));
@@ -1297,6 +1477,13 @@ bool Map::UnloadGrid(const uint32 &x, const uint32 &y, bool pForce)
         unloader.UnloadN();
         delete getNGrid(x, y);
         setNGrid(NULL, x, y);
+
+        GridPositionCache* positions = i_positionCaches[x][y];
+        for (uint32 cellX = 0; cellX < MAX_NUMBER_OF_CELLS; ++cellX)
+            for (uint32 cellY = 0; cellY < MAX_NUMBER_OF_CELLS; ++cellY)
+                positions->cells[cellX][cellY].Clear();
+        delete positions;
+        i_positionCaches[x][y] = NULL;
     }
 
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
@@ -3592,37 +3779,45 @@ WorldObject* Map::GetWorldObject(ObjectGuid guid)
     return NULL;
 }
 
-class ObjectUpdatePacketBuilder : public ACE_Based::Runnable
+class ObjectUpdatePacketBuilder
 {
 public:
-    ObjectUpdatePacketBuilder(std::set<Object*>::iterator& a, std::set<Object*>::iterator& b, uint32 now) : begin(a), end(b), beginTime(now), current(a)
+    ObjectUpdatePacketBuilder(Map::ClientUpdateList const& l, uint32 a, uint32 b, uint32 now) : list(l), begin(a), end(b), beginTime(now), current(a)
     {
     }
 
-    virtual void run()
-    {
-        WorldDatabase.ThreadStart(); // Not needed if we don't do SQL queries from this thread ...
-        DoUpdateObjects();
-        WorldDatabase.ThreadEnd();
-    }
     void DoUpdateObjects()
     {
         uint32 timeout = sWorld.getConfig(CONFIG_UINT32_MAP_OBJECTSUPDATE_TIMEOUT);
-        UpdateDataMapType update_players; // Player -> UpdateData
 
         for (; current != end; ++current)
         {
             if (WorldTimer::getMSTimeDiffToNow(beginTime) > timeout)
                 break;
-            (*current)->BuildUpdateData(update_players);
+            list[current]->BuildUpdateData(updatePlayers);
         }
+    }
 
-        for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
-            iter->second.Send(iter->first->GetSession());
+    // Blocks of the other builders are merged into this one, so that a player gets
+    // a single packet stream per tick whatever the number of builders involved.
+    void MergeFrom(ObjectUpdatePacketBuilder& other)
+    {
+        for (UpdateDataMapType::iterator iter = other.updatePlayers.begin(); iter != other.updatePlayers.end(); ++iter)
+        {
+            UpdateDataMapType::iterator target = updatePlayers.find(iter->first);
+            if (target == updatePlayers.end())
+                updatePlayers[iter->first].Merge(iter->second);
+            else
+                target->second.Merge(iter->second);
+        }
+        other.updatePlayers.clear();
     }
-    std::set<Object*>::iterator begin;
-    std::set<Object*>::iterator current;
-    std::set<Object*>::iterator end;
+
+    UpdateDataMapType updatePlayers; // Player -> UpdateData
+    Map::ClientUpdateList const& list;
+    uint32 begin;
+    uint32 current;
+    uint32 end;
     uint32 beginTime;
 };
 
@@ -3654,44 +3849,63 @@ void Map::SendObjectUpdates()
         threads = objectsCount;
 
     uint32 step = objectsCount / threads;
-    uint32 i = 0;
-    ACE_Based::Thread** updaters = threads > 1 ? new ACE_Based::Thread*[threads - 1] : NULL;
-    ObjectUpdatePacketBuilder** objUpdaters = new ObjectUpdatePacketBuilder*[threads];
-    std::set<Object*>::iterator itBegin = i_objectsToClientUpdate.begin();
-    std::set<Object*>::iterator itEnd = i_objectsToClientUpdate.begin();
     ASSERT(step > 0);
     ASSERT(threads >= 1);
+    ThreadPool::TaskGroup updatersGroup(sMapMgr.GetUpdatePool());
+    std::vector<ObjectUpdatePacketBuilder> objUpdaters;
+    objUpdaters.reserve(threads);
     for (uint32 i = 0; i < threads; ++i)
-    {
-        itBegin = itEnd;
-        if (i == (threads - 1))
-            itEnd = i_objectsToClientUpdate.end();
-        else
-        {
-            for (uint32 j = 0; j < step; ++j)
-                ++itEnd;
-        }
-        objUpdaters[i] = new ObjectUpdatePacketBuilder(itBegin, itEnd, now);
-        objUpdaters[i]->incReference();
+        objUpdaters.emplace_back(i_objectsToClientUpdate, i * step, i == (threads - 1) ? objectsCount : (i + 1) * step, now);
 
-        if (i == (threads - 1)) // Do not create a useless supplementary thread
-            objUpdaters[i]->DoUpdateObjects();
-        else
-            updaters[i] = new ACE_Based::Thread(objUpdaters[i]);
+    for (uint32 i = 0; i < (threads - 1); ++i)
+    {
+        ObjectUpdatePacketBuilder* builder = &objUpdaters[i];
+        updatersGroup.Run([builder]() { builder->DoUpdateObjects(); });
     }
+    // Do not queue a useless supplementary task
+    objUpdaters[threads - 1].DoUpdateObjects();
+    updatersGroup.Wait();
+
+    // Coalesce the blocks of every builder per player, then send each session its packets
+    // in parallel. Sessions are split between tasks, so a session is only fed by one thread.
+    ObjectUpdatePacketBuilder& merged = objUpdaters[threads - 1];
     for (uint32 i = 0; i < (threads - 1); ++i)
-        updaters[i]->wait();
-    for (uint32 i = 0; i < threads; ++i)
+        merged.MergeFrom(objUpdaters[i]);
+
+    std::atomic<uint32> packets(0);
+    std::vector<std::pair<Player*, UpdateData*>> sessions;
+    sessions.reserve(merged.updatePlayers.size());
+    for (UpdateDataMapType::iterator iter = merged.updatePlayers.begin(); iter != merged.updatePlayers.end(); ++iter)
+        sessions.emplace_back(iter->first, &iter->second);
+
+    uint32 senders = std::min<uint32>(threads, sessions.size());
+    for (uint32 i = 1; i < senders; ++i)
     {
-        /* std::set::erase
-         * Iterators, pointers and references referring to elements removed by the function are invalidated.
-         * All other iterators, pointers and references keep their validity.
-         */
-        i_objectsToClientUpdate.erase(objUpdaters[i]->begin, objUpdaters[i]->current);
-        objUpdaters[i]->decReference();
-        if (i != (threads - 1))
-            delete updaters[i];
+        std::pair<Player*, UpdateData*>* first = sessions.data() + (sessions.size() * i / senders);
+        std::pair<Player*, UpdateData*>* last = sessions.data() + (sessions.size() * (i + 1) / senders);
+        updatersGroup.Run([first, last, &packets]()
+        {
+            uint32 sent = 0;
+            for (std::pair<Player*, UpdateData*>* it = first; it != last; ++it)
+                sent += it->second->Send(it->first->GetSession());
+            packets += sent;
+        });
+    }
+    if (senders)
+    {
+        uint32 sent = 0;
+        for (uint32 i = 0; i < sessions.size() / senders; ++i)
+            sent += sessions[i].second->Send(sessions[i].first->GetSession());
+        packets += sent;
     }
+    updatersGroup.Wait();
+
+    // Drop what has been sent, from the end so that the ranges stay valid.
+    // Objects skipped because of the timeout are kept for the next update.
+    for (uint32 i = threads; i > 0; --i)
+        i_objectsToClientUpdate.erase(objUpdaters[i - 1].begin, objUpdaters[i - 1].current);
+    m_tickProfiler.AddCounter(MAP_COUNTER_OBJECTS_UPDATED, objectsCount - i_objectsToClientUpdate.size());
+    m_tickProfiler.AddCounter(MAP_COUNTER_UPDATE_PACKETS, packets);
 
     // If we timeout, use more threads !
     if (i_objectsToClientUpdate.size())
@@ -3700,8 +3914,6 @@ void Map::SendObjectUpdates()
         --_objUpdatesThreads;
 
     _processingSendObjUpdates = false;
-    delete[] updaters;
-    delete[] objUpdaters;
 #ifdef MAP_SENDOBJECTUPDATES_PROFILE
     uint32 diff = WorldTimer::getMSTimeDiffToNow(now);
     if (diff > 50)
@@ -3709,19 +3921,13 @@ void Map::SendObjectUpdates()
 #endif
 }
 
-class VisibilityUpdater : public ACE_Based::Runnable
+class VisibilityUpdater
 {
 public:
-    VisibilityUpdater(std::set<Unit*>::iterator& a, std::set<Unit*>::iterator& b, uint32 now) : begin(a), end(b), beginTime(now), current(a)
+    VisibilityUpdater(Map::RelocatedUnitsList const& l, uint32 a, uint32 b, uint32 now) : list(l), begin(a), end(b), beginTime(now), current(a)
     {
     }
 
-    virtual void run()
-    {
-        WorldDatabase.ThreadStart();
-        DoUpdateVisibility();
-        WorldDatabase.ThreadEnd();
-    }
     void DoUpdateVisibility()
     {
         uint32 timeout = sWorld.getConfig(CONFIG_UINT32_MAP_VISIBILITYUPDATE_TIMEOUT);
@@ -3729,21 +3935,52 @@ public:
         {
             if (WorldTimer::getMSTimeDiffToNow(beginTime) > timeout)
                 break;
-            (*current)->ProcessRelocationVisibilityUpdates();
+            static_cast<Unit*>(list[current])->ProcessRelocationVisibilityUpdates();
         }
     }
-    std::set<Unit*>::iterator begin;
-    std::set<Unit*>::iterator current;
-    std::set<Unit*>::iterator end;
+    Map::RelocatedUnitsList const& list;
+    uint32 begin;
+    uint32 current;
+    uint32 end;
     uint32 beginTime;
 };
 
+void Map::AddRelocatedUnit(Unit* obj)
+{
+    // The unit's list position must only be written by this map: queue it.
+    // 'm_needUpdateVisibility' keeps a unit from being queued twice.
+    i_unitsRelocated_lock.acquire();
+    i_unitsRelocatedQueue.push_back(obj);
+    i_unitsRelocated_lock.release();
+}
+
+void Map::RemoveRelocatedUnit(Unit* obj)
+{
+    ASSERT(!_processingUnitsRelocation);
+    i_unitsRelocated_lock.acquire();
+    std::vector<Unit*>::iterator itr = std::find(i_unitsRelocatedQueue.begin(), i_unitsRelocatedQueue.end(), obj);
+    if (itr != i_unitsRelocatedQueue.end())
+    {
+        *itr = i_unitsRelocatedQueue.back();
+        i_unitsRelocatedQueue.pop_back();
+    }
+    i_unitsRelocated.erase(obj);
+    i_unitsRelocated_lock.release();
+}
+
 //#define MAP_UPDATEVISIBILITY_PROFILE
 
 void Map::UpdateVisibilityForRelocations()
 {
     // VERY HEAVY LOAD in case of a lot of players at the same place
     uint32 now = WorldTimer::getMSTime();
+
+    i_unitsRelocated_lock.acquire();
+    for (std::vector<Unit*>::const_iterator itr = i_unitsRelocatedQueue.begin(); itr != i_unitsRelocatedQueue.end(); ++itr)
+        i_unitsRelocated.insert(*itr);
+    i_unitsRelocatedQueue.clear();
+    i_unitsRelocated_lock.release();
+
     uint32 objectsCount = i_unitsRelocated.size();
     if (!objectsCount)
         return;
@@ -3765,38 +4002,24 @@ void Map::UpdateVisibilityForRelocations()
         threads = objectsCount;
 
     uint32 step = objectsCount / threads;
-    uint32 i = 0;
-    ACE_Based::Thread** updaters = threads > 1 ? new ACE_Based::Thread*[threads - 1] : NULL;
-    VisibilityUpdater** visUpdaters = new VisibilityUpdater*[threads];
-    std::set<Unit*>::iterator itBegin = i_unitsRelocated.begin();
-    std::set<Unit*>::iterator itEnd = i_unitsRelocated.begin();
     ASSERT(step > 0);
+    ThreadPool::TaskGroup updatersGroup(sMapMgr.GetUpdatePool());
+    std::vector<VisibilityUpdater> visUpdaters;
+    visUpdaters.reserve(threads);
     for (uint32 i = 0; i < threads; ++i)
+        visUpdaters.emplace_back(i_unitsRelocated, i * step, i == (threads - 1) ? objectsCount : (i + 1) * step, now);
+
+    for (uint32 i = 0; i < (threads - 1); ++i)
     {
-        itBegin = itEnd;
-        if (i == (threads - 1))
-            itEnd = i_unitsRelocated.end();
-        else
-        {
-            for (uint32 j = 0; j < step; ++j)
-                ++itEnd;
-        }
-        visUpdaters[i] = new VisibilityUpdater(itBegin, itEnd, now);
-        visUpdaters[i]->incReference();
-        if (i == (threads - 1))
-            visUpdaters[i]->DoUpdateVisibility();
-        else
-            updaters[i] = new ACE_Based::Thread(visUpdaters[i]);
-    }
-    for (uint32 i = 0; i < threads - 1; ++i)
-        updaters[i]->wait();
-    for (uint32 i = 0; i < threads; ++i)
-    {
-        i_unitsRelocated.erase(visUpdaters[i]->begin, visUpdaters[i]->current);
-        visUpdaters[i]->decReference();
-        if (i != (threads - 1))
-            delete updaters[i];
+        VisibilityUpdater* updater = &visUpdaters[i];
+        updatersGroup.Run([updater]() { updater->DoUpdateVisibility(); });
     }
+    visUpdaters[threads - 1].DoUpdateVisibility();
+    updatersGroup.Wait();
+
+    for (uint32 i = threads; i > 0; --i)
+        i_unitsRelocated.erase(visUpdaters[i - 1].begin, visUpdaters[i - 1].current);
+    m_tickProfiler.AddCounter(MAP_COUNTER_RELOCATIONS, objectsCount - i_unitsRelocated.size());
 
     if (i_unitsRelocated.size())
         ++_unitRelocationThreads;
@@ -3804,8 +4027,6 @@ void Map::UpdateVisibilityForRelocations()
         --_unitRelocationThreads;
 
     _processingUnitsRelocation = false;
-    delete[] updaters;
-    delete[] visUpdaters;
 
 #ifdef MAP_UPDATEVISIBILITY_PROFILE
     uint32 diff = WorldTimer::getMSTimeDiffToNow(now);
@@ -3960,6 +4181,17 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
     && (!checkDynLos || CheckDynamicTreeLoS(x1, y1, z1, x2, y2, z2));
 }
 
+void Map::isInLineOfSight(float const* from, float const* to, uint32 count, bool* results, bool checkDynLos) const
+{
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), from, to, count, results);
+    if (!checkDynLos)
+        return;
+
+    for (uint32 i = 0; i < count; ++i)
+        if (results[i])
+            results[i] = CheckDynamicTreeLoS(from[i * 3], from[i * 3 + 1], from[i * 3 + 2], to[i * 3], to[i * 3 + 1], to[i * 3 + 2]);
+}
+
 bool Map::GetLosHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const
 {
     ASSERT(MaNGOS::IsValidMapCoord(srcX, srcY, srcZ));
@@ -4246,5 +4478,9 @@ void Map::PrintInfos(ChatHandler& handler)
     handler.PSendSysMessage("%u objects to client update [%u threads]", i_objectsToClientUpdate.size(), _objUpdatesThreads);
     handler.PSendSysMessage("%u objects relocated [%u threads]", i_unitsRelocated.size(), _unitRelocationThreads);
     handler.PSendSysMessage("%u scripts scheduled", m_scriptSchedule.size());
+    if (m_cellsUpdateStats.threads)
+        handler.PSendSysMessage("Cells update: %u cells in %u shards, %u threads. %uus [busy max %uus avg %uus, biggest shard %uus]",
+            m_cellsUpdateStats.cells, m_cellsUpdateStats.shards, m_cellsUpdateStats.threads, m_cellsUpdateStats.wallTime,
+            m_cellsUpdateStats.maxBusyTime, m_cellsUpdateStats.avgBusyTime, m_cellsUpdateStats.maxShardTime);
     handler.PSendSysMessage("Vis:%.1f Act:%.1f", m_VisibleDistance, m_GridActivationDistance);
 }
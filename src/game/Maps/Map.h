@@ -35,6 +35,9 @@
 #include "GridMap.h"
 #include "GameSystem/GridRefManager.h"
 #include "MapRefManager.h"
+#include "MapTickProfiler.h"
+#include "CellPositionCache.h"
+#include "PathRequestService.h"
 #include "Utilities/TypeList.h"
 #include "ScriptMgr.h"
 #include "vmap/DynamicTree.h"
@@ -198,8 +201,19 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         Map(uint32 id, time_t, uint32 InstanceId);
 
     public:
+        typedef DirtyList<Object, &Object::GetClientUpdateListElement> ClientUpdateList;
+        typedef DirtyList<WorldObject, &WorldObject::GetRelocatedListElement> RelocatedUnitsList;
+
         virtual ~Map();
         void PrintInfos(ChatHandler& handler);
+        MapTickProfiler& GetTickProfiler() { return m_tickProfiler; }
+        PathRequestService& GetPathRequests() { return m_pathRequests; }
+        // Units positions of the cell, null if its grid is not created
+        CellPositionCache* GetCellPositionCache(Cell const& cell) const
+        {
+            GridPositionCache* grid = i_positionCaches[cell.GridX()][cell.GridY()];
+            return grid ? &grid->cells[cell.CellX()][cell.CellY()] : nullptr;
+        }
         void SpawnActiveObjects();
         // currently unused for normal maps
         bool CanUnload(uint32 diff)
@@ -222,13 +236,15 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         inline void UpdateActiveCellsSynch(uint32 now, uint32 diff);
         inline void MarkCellsAroundObject(WorldObject const* object);
         inline void UpdateActiveCellsAsynch(uint32 now, uint32 diff);
-        inline void UpdateActiveCellsCallback(uint32 diff, uint32 now, uint32 threadId, uint32 totalThreads, uint32 step);
+        inline void UpdateActiveCellsCallback(uint32 diff, uint32 now, std::vector<uint32> const& cells);
         inline void UpdateCells(uint32 diff);
         void UpdateSync(const uint32);
         void UpdatePlayers();
         void DoUpdate(uint32 maxDiff);
         virtual void Update(uint32);
         void UpdateSessionsMovementAndSpellsIfNeeded();
+        // Milliseconds before UpdateSessionsMovementAndSpellsIfNeeded or UpdatePlayers have something to do
+        uint32 GetNextPeriodicUpdateDelay() const;
         void ProcessSessionPackets(PacketProcessing type);
 
         void MessageBroadcast(Player*, WorldPacket*, bool to_self);
@@ -307,6 +323,19 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         bool isCellMarked(uint32 pCellId) { return marked_cells.test(pCellId); }
         void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
 
+        // Multithreaded cells update (continents), times in microseconds
+        struct CellsUpdateStats
+        {
+            CellsUpdateStats() : shards(0), cells(0), threads(0), wallTime(0), maxBusyTime(0), avgBusyTime(0), maxShardTime(0) {}
+            uint32 shards;
+            uint32 cells;
+            uint32 threads;
+            uint32 wallTime;
+            uint32 maxBusyTime;                             // busiest thread
+            uint32 avgBusyTime;
+            uint32 maxShardTime;                            // lower bound of wallTime
+        };
+
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(uint32 x,uint32 y) const;
@@ -373,22 +402,10 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
             i_objectsToClientUpdate.erase( obj );
             i_objectsToClientUpdate_lock.release();
         }
-        // May be called from a different map ...
-        void AddRelocatedUnit(Unit* obj)
-        {
-            if (_processingUnitsRelocation)
-                return;
-            i_unitsRelocated_lock.acquire();
-            i_unitsRelocated.insert(obj);
-            i_unitsRelocated_lock.release();
-        }
-        void RemoveRelocatedUnit(Unit* obj)
-        {
-            ASSERT(!_processingUnitsRelocation);
-            i_unitsRelocated_lock.acquire();
-            i_unitsRelocated.erase(obj);
-            i_unitsRelocated_lock.release();
-        }
+        // May be called from a different map: the unit is only queued, and this
+        // map moves it to its own relocation list on its thread.
+        void AddRelocatedUnit(Unit* obj);
+        void RemoveRelocatedUnit(Unit* obj);
 
         void AddUnitToMovementUpdate(Unit* unit)
         {
@@ -420,6 +437,8 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         // GameObjectCollision
         float GetHeight(float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, bool checkDynLos = true) const;
+        // Batched version for rays close to each other: positions are count x,y,z triples
+        void isInLineOfSight(float const* from, float const* to, uint32 count, bool* results, bool checkDynLos = true) const;
         // First collision with object
         bool GetLosHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const;
         // Use navemesh to walk
@@ -525,12 +544,13 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         bool                    _processingSendObjUpdates;
         uint32                  _objUpdatesThreads;
         mutable MapMutexType    i_objectsToClientUpdate_lock;
-        std::set<Object *>      i_objectsToClientUpdate;
+        ClientUpdateList        i_objectsToClientUpdate;
 
         bool                    _processingUnitsRelocation;
         uint32                  _unitRelocationThreads;
         mutable MapMutexType    i_unitsRelocated_lock;
-        std::set<Unit* >        i_unitsRelocated;
+        std::vector<Unit*>      i_unitsRelocatedQueue;          // under i_unitsRelocated_lock
+        RelocatedUnitsList      i_unitsRelocated;               // map thread only
 
         mutable MapMutexType    unitsMvtUpdate_lock;
         std::set<Unit*>         unitsMvtUpdate;
@@ -572,12 +592,17 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>, public MaNGOS::Obj
         time_t i_gridExpiry;
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        GridPositionCache* i_positionCaches[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         //Shared geodata object with map coord info...
         TerrainInfo * const m_TerrainData;
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP*TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::vector<uint32> m_markedCellsList;              // same, for UpdateActiveCellsAsynch
+        CellsUpdateStats m_cellsUpdateStats;                // last UpdateActiveCellsAsynch
+        MapTickProfiler m_tickProfiler;
+        PathRequestService m_pathRequests;                  // mmap.async
 
         mutable MapMutexType    i_objectsToRemove_lock;
         std::set<WorldObject *> i_objectsToRemove;
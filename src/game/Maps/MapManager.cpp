@@ -29,6 +29,7 @@
 #include "ObjectMgr.h"
 #include "ZoneScriptMgr.h"
 #include "Map.h"
+#include "WorldSocketMgr.h"
 
 typedef MaNGOS::ClassLevelLockable<MapManager, ACE_Recursive_Thread_Mutex> MapManagerLock;
 INSTANTIATE_SINGLETON_2(MapManager, MapManagerLock);
@@ -38,14 +39,17 @@ MapManager::MapManager()
     : i_gridCleanUpDelay(sWorld.getConfig(CONFIG_UINT32_INTERVAL_GRIDCLEAN)),
     i_MaxInstanceId(RESERVED_INSTANCES_LAST),
     i_GridStateErrorCount(0),
-    i_continentUpdateFinished(NULL),
-    i_maxContinentThread(0)
+    m_nextProfileDump(0),
+    m_lastSendCalls(0),
+    m_lastSentPackets(0)
 {
     i_timer.SetInterval(sWorld.getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 }
 
 MapManager::~MapManager()
 {
+    m_updatePool.Stop();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
@@ -57,6 +61,9 @@ MapManager::Initialize()
 {
     InitStateMachine();
     InitMaxInstanceId();
+    m_updatePool.Start(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_WORKER_THREADS), sWorld.getConfig(CONFIG_BOOL_MAPUPDATE_PIN_WORKER_THREADS),
+        []() { WorldDatabase.ThreadStart(); }, []() { WorldDatabase.ThreadEnd(); });
+    sLog.outString("Map update pool started with %u workers", uint32(m_updatePool.GetThreadCount()));
     for (auto itr = sMapStorage.begin<MapEntry>(); itr < sMapStorage.end<MapEntry>(); ++itr)
     {
         bool load = false;
@@ -236,55 +243,35 @@ void MapManager::DeleteInstance(uint32 mapid, uint32 instanceId)
     }
 }
 
-class MapAsyncUpdater : public ACE_Based::Runnable
+class MapAsyncUpdater
 {
 public:
-    MapAsyncUpdater(bool* updFinished, uint32 updateDiff) :
+    MapAsyncUpdater(MapUpdateBarrier* updFinished, uint32 updateDiff) :
         updateFinished(updFinished), diff(updateDiff), loops(0)
     {
     }
 
-    virtual void run()
+    void run()
     {
-        WorldDatabase.ThreadStart();
         do
         {
             for (std::vector<Map*>::iterator it = maps.begin(); it != maps.end(); ++it)
             {
-                if (loops && *updateFinished)
+                if (loops && updateFinished->IsOpen())
                     break;
                 (*it)->DoUpdate(diff);
             }
-            if (!(*updateFinished))
-                ACE_Based::Thread::Sleep(5);
             ++loops;
         }
-        while (!(*updateFinished));
-        WorldDatabase.ThreadEnd();
+        // Continents still running: let the instances breathe a bit, but leave as soon as they are done
+        while (!updateFinished->Wait(5));
     }
     std::vector<Map*> maps;
-    volatile bool* updateFinished;
+    MapUpdateBarrier* updateFinished;
     uint32 diff;
     uint32 loops;
 };
 
-class ContinentAsyncUpdater : public ACE_Based::Runnable
-{
-public:
-    ContinentAsyncUpdater(uint32 updateDiff, Map* m) : diff(updateDiff), map(m)
-    {
-    }
-
-    virtual void run()
-    {
-        WorldDatabase.ThreadStart();
-        map->DoUpdate(diff);
-        WorldDatabase.ThreadEnd();
-    }
-    Map* map;
-    uint32 diff;
-};
-
 void MapManager::Update(uint32 diff)
 {
     i_timer.Update(diff);
@@ -292,11 +279,9 @@ void MapManager::Update(uint32 diff)
         return;
 
     uint32 mapsDiff = (uint32)i_timer.GetCurrent();
-    bool updateFinished = false;
-    std::vector<MapAsyncUpdater*> instanceUpdaters(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS));
-    std::vector<ContinentAsyncUpdater*> continentsUpdaters;
-    for (int i = 0; i < instanceUpdaters.size(); ++i)
-        instanceUpdaters[i] = new MapAsyncUpdater(&updateFinished, mapsDiff); // Will be deleted at thread end
+    m_continentsDone.Reset(1);
+    std::vector<MapAsyncUpdater> instanceUpdaters(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS), MapAsyncUpdater(&m_continentsDone, mapsDiff));
+    std::vector<Map*> continentsToUpdate;
 
     int mapIdx = 0;
     int continentsIdx = 0;
@@ -316,48 +301,58 @@ void MapManager::Update(uint32 diff)
         {
             if (instanceUpdaters.size())
             {
-                instanceUpdaters[mapIdx % instanceUpdaters.size()]->maps.push_back(iter->second);
+                instanceUpdaters[mapIdx % instanceUpdaters.size()].maps.push_back(iter->second);
                 ++mapIdx;
             }
             else
                 iter->second->Update(mapsDiff);
         }
-        else // One threat per continent part
+        else // One task per continent part
         {
             iter->second->SetMapUpdateIndex(continentsIdx++);
-            ContinentAsyncUpdater* task = new ContinentAsyncUpdater(mapsDiff, iter->second);
-            continentsUpdaters.push_back(task);
+            continentsToUpdate.push_back(iter->second);
         }
     }
-    i_maxContinentThread = continentsIdx;
-    i_continentUpdateFinished = new volatile bool[i_maxContinentThread];
-    for (int i = 0; i < i_maxContinentThread; ++i)
-        i_continentUpdateFinished[i] = false;
-
-    std::vector<ACE_Based::Thread*> asyncUpdateThreads(instanceUpdaters.size() + continentsUpdaters.size());
+    m_continentsBarrier.Reset(continentsIdx);
 
-    for (int tid = 0; tid < instanceUpdaters.size(); ++tid)
-        asyncUpdateThreads[tid]                             = new ACE_Based::Thread(instanceUpdaters[tid]);
-    for (int tid = 0; tid < continentsUpdaters.size(); ++tid)
-        asyncUpdateThreads[tid + instanceUpdaters.size()]   = new ACE_Based::Thread(continentsUpdaters[tid]);
+    // Map updates block (instances loop until continents are done, continents wait for each other):
+    // each of them needs its own worker, the remaining ones run the sub-tasks forked by the maps.
+    m_updatePool.Reserve(instanceUpdaters.size() + continentsToUpdate.size() + 1);
 
-    // Finish continents updating
-    for (int tid = instanceUpdaters.size(); tid < asyncUpdateThreads.size(); ++tid)
+    ThreadPool::TaskGroup instancesGroup(m_updatePool);
+    ThreadPool::TaskGroup continentsGroup(m_updatePool);
+    for (std::vector<MapAsyncUpdater>::iterator it = instanceUpdaters.begin(); it != instanceUpdaters.end(); ++it)
     {
-        asyncUpdateThreads[tid]->wait();
-        delete asyncUpdateThreads[tid];
+        MapAsyncUpdater* updater = &(*it);
+        instancesGroup.RunLong([updater]() { updater->run(); });
     }
+    for (std::vector<Map*>::iterator it = continentsToUpdate.begin(); it != continentsToUpdate.end(); ++it)
+    {
+        Map* map = *it;
+        continentsGroup.RunLong([map, mapsDiff]() { map->DoUpdate(mapsDiff); });
+    }
+
+    // Finish continents updating
+    continentsGroup.Wait();
 
-    updateFinished = true;
+    m_continentsDone.Arrive();
     SwitchPlayersInstances();
 
     // And then instances updating
-    for (int tid = 0; tid < instanceUpdaters.size(); ++tid)
+    instancesGroup.Wait();
+
+    // Every map is idle here
+    if (uint32 dumpInterval = sWorld.getConfig(CONFIG_UINT32_PERFLOG_PROFILE_DUMP_INTERVAL))
     {
-        asyncUpdateThreads[tid]->wait();
-        delete asyncUpdateThreads[tid];
+        time_t now = time(nullptr);
+        if (!m_nextProfileDump)
+            m_nextProfileDump = now + dumpInterval;
+        else if (now >= m_nextProfileDump)
+        {
+            DumpTickProfiles();
+            m_nextProfileDump = now + dumpInterval;
+        }
     }
-    delete[] i_continentUpdateFinished;
 
     MapMapType::iterator crashedMapsIter = i_maps.begin();
     while (crashedMapsIter != i_maps.end())
@@ -393,6 +388,30 @@ void MapManager::Update(uint32 diff)
     i_timer.SetCurrent(0);
 }
 
+void MapManager::DumpTickProfiles()
+{
+    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+    {
+        MapTickProfiler& profiler = iter->second->GetTickProfiler();
+        profiler.Dump(iter->second->GetId(), iter->second->GetInstanceId());
+        profiler.Reset();
+    }
+
+    uint64 sendCalls, packets;
+    sWorldSocketMgr->GetSendStats(sendCalls, packets);
+    if (packets != m_lastSentPackets)
+        sLog.out(LOG_PROFILER, "Network: " UI64FMTD " send calls for " UI64FMTD " packets (%.3f per packet)",
+            sendCalls - m_lastSendCalls, packets - m_lastSentPackets,
+            double(sendCalls - m_lastSendCalls) / double(packets - m_lastSentPackets));
+    m_lastSendCalls = sendCalls;
+    m_lastSentPackets = packets;
+
+    CharacterDatabase.DumpAsyncStats("Character");
+    WorldDatabase.DumpAsyncStats("World");
+    LoginDatabase.DumpAsyncStats("Login");
+    LogsDatabase.DumpAsyncStats("Logs");
+}
+
 void MapManager::RemoveAllObjectsInRemoveList()
 {
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
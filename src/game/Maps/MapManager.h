@@ -27,6 +27,12 @@
 #include "ace/Thread_Mutex.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 class BattleGround;
 
@@ -70,6 +76,50 @@ struct MANGOS_DLL_DECL MapID
     uint32 nInstanceId;
 };
 
+/**
+ * Meeting point of the maps updated in parallel. A thread done with its part
+ * waits for the others with a timeout, so that it can do useful work until
+ * everybody arrived, and is woken up as soon as the last one does.
+ */
+class MapUpdateBarrier
+{
+    public:
+        MapUpdateBarrier() : m_remaining(0) {}
+
+        void Reset(uint32 participants)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_remaining = participants;
+        }
+
+        void Arrive()
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                MANGOS_ASSERT(m_remaining);
+                if (--m_remaining)
+                    return;
+            }
+            m_cond.notify_all();
+        }
+
+        bool IsOpen() const { return m_remaining == 0; }
+
+        // Returns true once every participant arrived, false if 'timeoutMs' expired before
+        bool Wait(uint32 timeoutMs)
+        {
+            if (IsOpen())
+                return true;
+            std::unique_lock<std::mutex> lock(m_lock);
+            return m_cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return m_remaining == 0; });
+        }
+
+    private:
+        std::mutex m_lock;
+        std::condition_variable m_cond;
+        std::atomic<uint32> m_remaining;
+};
+
 class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockable<MapManager, ACE_Recursive_Thread_Mutex> >
 {
     friend class MaNGOS::OperatorNew<MapManager>;
@@ -176,18 +226,15 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         void ScheduleInstanceSwitch(Player* player, uint16 newInstance);
         void SwitchPlayersInstances();
 
-        void MarkContinentUpdateFinished(int idx)
-        {
-            ASSERT(idx < i_maxContinentThread);
-            i_continentUpdateFinished[idx] = true;
-        }
-        bool IsContinentUpdateFinished()
-        {
-            for (int i = 0; i < i_maxContinentThread; ++i)
-                if (!i_continentUpdateFinished[i])
-                    return false;
-            return true;
-        }
+        // Continent parts wait for each other at the end of their update
+        void MarkContinentUpdateFinished() { m_continentsBarrier.Arrive(); }
+        bool WaitContinentsUpdate(uint32 timeoutMs) { return m_continentsBarrier.Wait(timeoutMs); }
+
+        // Workers shared by all map update phases
+        ThreadPool& GetUpdatePool() { return m_updatePool; }
+
+        // Writes the tick profile of every map, the network send stats and the database worker stats to the profiler log, and starts a new interval
+        void DumpTickProfiles();
     private:
 
         // debugging code, should be deleted some day
@@ -214,8 +261,12 @@ class MANGOS_DLL_DECL MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::
         IntervalTimer i_timer;
 
         uint32 i_MaxInstanceId;
-        int             i_maxContinentThread;
-        volatile bool*  i_continentUpdateFinished;
+        MapUpdateBarrier m_continentsBarrier;               // continent Map::Update reached their end
+        MapUpdateBarrier m_continentsDone;                  // continent tasks returned, instances can stop
+        ThreadPool      m_updatePool;
+        time_t          m_nextProfileDump;
+        uint64          m_lastSendCalls;                    // network stats at the previous dump
+        uint64          m_lastSentPackets;
 
         // Instanced continent zones
         const static int LAST_CONTINENT_ID = 2;
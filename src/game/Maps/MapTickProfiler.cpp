@@ -0,0 +1,104 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapTickProfiler.h"
+#include "Log.h"
+
+static char const* const s_phaseNames[MAX_MAP_TICK_PHASES] =
+{
+    "sessions",
+    "players",
+    "cells",
+    "sendObjUpdates",
+    "relocations",
+    "players2",
+    "wait",
+    "grids+scripts",
+    "total"
+};
+
+MapTickProfiler::MapTickProfiler()
+{
+    Reset();
+}
+
+void MapTickProfiler::BeginTick()
+{
+    m_tickStart = Clock::now();
+    m_phaseStart = m_tickStart;
+}
+
+void MapTickProfiler::EndPhase(MapTickPhase phase)
+{
+    Clock::time_point now = Clock::now();
+    m_phases[phase].Record(std::chrono::duration_cast<std::chrono::microseconds>(now - m_phaseStart).count());
+    m_phaseStart = now;
+}
+
+void MapTickProfiler::EndTick()
+{
+    m_phases[MAP_TICK_TOTAL].Record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_tickStart).count());
+    AddCounter(MAP_COUNTER_TICKS, 1);
+}
+
+uint32 MapTickProfiler::GetIntervalDuration() const
+{
+    return uint32(time(nullptr) - m_intervalStart);
+}
+
+void MapTickProfiler::Reset()
+{
+    for (int i = 0; i < MAX_MAP_TICK_PHASES; ++i)
+        m_phases[i].Reset();
+    for (int i = 0; i < MAX_MAP_COUNTERS; ++i)
+        m_counters[i].store(0, std::memory_order_relaxed);
+    m_intervalStart = time(nullptr);
+}
+
+char const* MapTickProfiler::GetPhaseName(MapTickPhase phase)
+{
+    return s_phaseNames[phase];
+}
+
+std::string MapTickProfiler::FormatPhase(MapTickPhase phase) const
+{
+    LatencyHistogram const& histo = m_phases[phase];
+    char buffer[200];
+    snprintf(buffer, sizeof(buffer), "%-14s p50 %6uus p90 %6uus p99 %6uus max %6uus avg %6uus",
+        s_phaseNames[phase], uint32(histo.GetPercentile(50)), uint32(histo.GetPercentile(90)),
+        uint32(histo.GetPercentile(99)), uint32(histo.GetMax()), uint32(histo.GetMean()));
+    return buffer;
+}
+
+std::string MapTickProfiler::FormatCounters() const
+{
+    char buffer[200];
+    snprintf(buffer, sizeof(buffer), "%u ticks in %us | objects updated " UI64FMTD " | update packets " UI64FMTD " | cells visited " UI64FMTD " | relocations " UI64FMTD,
+        uint32(GetCounter(MAP_COUNTER_TICKS)), GetIntervalDuration(), GetCounter(MAP_COUNTER_OBJECTS_UPDATED),
+        GetCounter(MAP_COUNTER_UPDATE_PACKETS), GetCounter(MAP_COUNTER_CELLS_VISITED), GetCounter(MAP_COUNTER_RELOCATIONS));
+    return buffer;
+}
+
+void MapTickProfiler::Dump(uint32 mapId, uint32 instanceId) const
+{
+    if (!GetCounter(MAP_COUNTER_TICKS))
+        return;
+
+    sLog.out(LOG_PROFILER, "Map %u inst %u: %s", mapId, instanceId, FormatCounters().c_str());
+    for (int i = 0; i < MAX_MAP_TICK_PHASES; ++i)
+        if (m_phases[i].GetCount())
+            sLog.out(LOG_PROFILER, "Map %u inst %u: %s", mapId, instanceId, FormatPhase(MapTickPhase(i)).c_str());
+}
@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPTICKPROFILER_H
+#define MANGOS_MAPTICKPROFILER_H
+
+#include "Common.h"
+#include "LatencyHistogram.h"
+#include <chrono>
+#include <string>
+
+// Phases of Map::Update, in execution order
+enum MapTickPhase
+{
+    MAP_TICK_SESSIONS           = 0,
+    MAP_TICK_PLAYERS,
+    MAP_TICK_CELLS,
+    MAP_TICK_SEND_OBJ_UPDATES,
+    MAP_TICK_RELOCATIONS,
+    MAP_TICK_PLAYERS2,
+    MAP_TICK_WAIT,
+    MAP_TICK_GRIDS_SCRIPTS,
+    MAP_TICK_TOTAL,
+    MAX_MAP_TICK_PHASES
+};
+
+enum MapTickCounter
+{
+    MAP_COUNTER_TICKS           = 0,
+    MAP_COUNTER_OBJECTS_UPDATED,                            // objects whose changes were sent to clients
+    MAP_COUNTER_UPDATE_PACKETS,                             // SMSG_UPDATE_OBJECT packets built
+    MAP_COUNTER_CELLS_VISITED,
+    MAP_COUNTER_RELOCATIONS,                                // visibility updates after a move
+    MAX_MAP_COUNTERS
+};
+
+/**
+ * Always-on instrumentation of Map::Update: one latency histogram per phase and
+ * a few counters, over an interval started by the last Reset().
+ * Only the map update thread records. Reading from another thread (.perf command)
+ * gives a slightly inconsistent snapshot, which is fine for monitoring.
+ */
+class MapTickProfiler
+{
+    public:
+        MapTickProfiler();
+
+        void BeginTick();
+        // Records the time elapsed since the previous phase (or the beginning of the tick)
+        void EndPhase(MapTickPhase phase);
+        void EndTick();
+
+        void AddCounter(MapTickCounter counter, uint64 value)
+        {
+            m_counters[counter].store(m_counters[counter].load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        LatencyHistogram const& GetHistogram(MapTickPhase phase) const { return m_phases[phase]; }
+        uint64 GetCounter(MapTickCounter counter) const { return m_counters[counter].load(std::memory_order_relaxed); }
+        // Length of the current interval, in seconds
+        uint32 GetIntervalDuration() const;
+
+        void Reset();
+
+        // "cells       p50 1200us p90 ... max ..." line for reports
+        std::string FormatPhase(MapTickPhase phase) const;
+        std::string FormatCounters() const;
+        // Writes the current interval to the profiler log
+        void Dump(uint32 mapId, uint32 instanceId) const;
+
+        static char const* GetPhaseName(MapTickPhase phase);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        LatencyHistogram m_phases[MAX_MAP_TICK_PHASES];
+        std::atomic<uint64> m_counters[MAX_MAP_COUNTERS];
+        Clock::time_point m_tickStart;
+        Clock::time_point m_phaseStart;
+        time_t m_intervalStart;
+};
+
+#endif
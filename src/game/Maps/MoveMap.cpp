@@ -25,6 +25,54 @@
 
 namespace MMAP
 {
+std::atomic<uint32> MMapData::lastSerial(0);
+
+// Navmesh queries of one thread, by map id or gameobject displayId
+class ThreadNavMeshQueries
+{
+    public:
+        ~ThreadNavMeshQueries()
+        {
+            for (QueryMap::iterator i = m_queries.begin(); i != m_queries.end(); ++i)
+                dtFreeNavMeshQuery(i->second.query);
+        }
+
+        // Query made for this data, or nullptr. A query made for data since unloaded is freed
+        // (the query only references the navmesh, never reads it on destruction).
+        dtNavMeshQuery* Find(uint32 id, MMapData const* data)
+        {
+            QueryMap::iterator it = m_queries.find(id);
+            if (it == m_queries.end())
+                return nullptr;
+            if (it->second.serial == data->serial)
+                return it->second.query;
+
+            dtFreeNavMeshQuery(it->second.query);
+            m_queries.erase(it);
+            return nullptr;
+        }
+
+        void Add(uint32 id, MMapData const* data, dtNavMeshQuery* query)
+        {
+            Entry& entry = m_queries[id];
+            entry.serial = data->serial;
+            entry.query = query;
+        }
+
+    private:
+        struct Entry
+        {
+            uint32 serial;
+            dtNavMeshQuery* query;
+        };
+        typedef UNORDERED_MAP<uint32, Entry> QueryMap;
+
+        QueryMap m_queries;
+};
+
+static thread_local ThreadNavMeshQueries t_mapQueries;
+static thread_local ThreadNavMeshQueries t_modelQueries;
+
 // ######################## MMapFactory ########################
 // our global singelton copy
 MMapManager *g_MMapManager = NULL;
@@ -273,7 +321,7 @@ bool MMapManager::unloadMap(uint32 mapId)
     return true;
 }
 
-bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
+bool MMapManager::unloadMapInstance(uint32 mapId, uint32 /*instanceId*/)
 {
     // check if we have this map loaded
     if (loadedMMaps.find(mapId) == loadedMMaps.end())
@@ -283,19 +331,7 @@ bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
         return false;
     }
 
-    MMapData* mmap = loadedMMaps[mapId];
-    if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
-    {
-        DEBUG_LOG("MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
-        return false;
-    }
-
-    dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-    dtFreeNavMeshQuery(query);
-    mmap->navMeshQueries.erase(instanceId);
-    DETAIL_LOG("MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
-
+    // navmesh queries belong to threads, not to instances: nothing to release
     return true;
 }
 
@@ -309,38 +345,27 @@ dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
 
 dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId)
 {
-    if (loadedMMaps.find(mapId) == loadedMMaps.end())
+    MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+    if (itr == loadedMMaps.end())
         return NULL;
 
-    uint32 tid = ACE_Based::Thread::currentId();
-    MMapData* mmap = loadedMMaps[mapId];
-    mmap->navMeshQueries_lock.acquire_read();
+    MMapData* mmap = itr->second;
+    if (dtNavMeshQuery* navMeshQuery = t_mapQueries.Find(mapId, mmap))
+        return navMeshQuery;
 
-    NavMeshQuerySet::iterator it = mmap->navMeshQueries.find(tid);
-    dtNavMeshQuery* navMeshQuery = NULL;
-    if (it == mmap->navMeshQueries.end())
+    // allocate mesh query
+    uint32 tid = ACE_Based::Thread::currentId();
+    dtNavMeshQuery* navMeshQuery = dtAllocNavMeshQuery();
+    MANGOS_ASSERT(navMeshQuery);
+    if (DT_SUCCESS != navMeshQuery->init(mmap->navMesh, 2048, tid))
     {
-        mmap->navMeshQueries_lock.release();
-        mmap->navMeshQueries_lock.acquire_write();
-
-        // allocate mesh query
-        navMeshQuery = dtAllocNavMeshQuery();
-        MANGOS_ASSERT(navMeshQuery);
-        if (DT_SUCCESS != navMeshQuery->init(mmap->navMesh, 2048, tid))
-        {
-            mmap->navMeshQueries_lock.release();
-            dtFreeNavMeshQuery(navMeshQuery);
-            sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u thread %u", mapId, tid);
-            return NULL;
-        }
-
-        DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u thread %u", mapId, tid);
-        mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(tid, navMeshQuery));
+        dtFreeNavMeshQuery(navMeshQuery);
+        sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u thread %u", mapId, tid);
+        return NULL;
     }
-    else
-        navMeshQuery = it->second;
-    mmap->navMeshQueries_lock.release();
 
+    DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u thread %u", mapId, tid);
+    t_mapQueries.Add(mapId, mmap, navMeshQuery);
     return navMeshQuery;
 }
 
@@ -413,31 +438,27 @@ bool MMapManager::loadGameObject(uint32 displayId)
 
 dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
 {
-    if (loadedModels.find(displayId) == loadedModels.end())
+    MMapDataSet::const_iterator itr = loadedModels.find(displayId);
+    if (itr == loadedModels.end())
         return NULL;
 
+    MMapData* mmap = itr->second;
+    if (dtNavMeshQuery* query = t_modelQueries.Find(displayId, mmap))
+        return query;
+
+    // allocate mesh query
     uint32 tid = ACE_Based::Thread::currentId();
-    MMapData* mmap = loadedModels[displayId];
-    if (mmap->navMeshQueries.find(tid) == mmap->navMeshQueries.end())
+    dtNavMeshQuery* query = dtAllocNavMeshQuery();
+    MANGOS_ASSERT(query);
+    if (dtStatusFailed(query->init(mmap->navMesh, 2048, tid)))
     {
-        ACE_Guard<ACE_Thread_Mutex> g(lockForModels);
-        if (mmap->navMeshQueries.find(tid) == mmap->navMeshQueries.end())
-        {
-            // allocate mesh query
-            dtNavMeshQuery* query = dtAllocNavMeshQuery();
-            MANGOS_ASSERT(query);
-            if (dtStatusFailed(query->init(mmap->navMesh, 2048, tid)))
-            {
-                dtFreeNavMeshQuery(query);
-                sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u tid %u", displayId, tid);
-                return NULL;
-            }
-
-            DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for displayid %03u tid %u", displayId, tid);
-            mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(tid, query));
-        }
+        dtFreeNavMeshQuery(query);
+        sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u tid %u", displayId, tid);
+        return NULL;
     }
 
-    return mmap->navMeshQueries[tid];
+    DETAIL_LOG("MMAP:GetNavMeshQuery: created dtNavMeshQuery for displayid %03u tid %u", displayId, tid);
+    t_modelQueries.Add(displayId, mmap, query);
+    return query;
 }
 }
@@ -25,6 +25,8 @@
 
 #include "Utilities/UnorderedMapSet.h"
 
+#include <atomic>
+
 #include "Detour/Include/DetourAlloc.h"
 #include "Detour/Include/DetourNavMesh.h"
 #include "Detour/Include/DetourNavMeshQuery.h"
@@ -44,28 +46,26 @@ inline void dtCustomFree(void* ptr)
 namespace MMAP
 {
     typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
-    typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), serial(++lastSerial) {}
         ~MMapData()
         {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
-
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // threadId to query
-        ACE_RW_Mutex navMeshQueries_lock;
+        // dtNavMeshQuery are not thread safe, every thread keeps its own ones (see MMapManager::GetNavMeshQuery)
+        // and recreates them when the serial of the data they were made for changed
+        uint32 const serial;
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
         ACE_Thread_Mutex tilesLoading_lock;
+
+        static std::atomic<uint32> lastSerial;
     };
 
     typedef UNORDERED_MAP<uint32, MMapData*> MMapDataSet;
@@ -85,7 +85,8 @@ namespace MMAP
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
             // The returned [dtNavMeshQuery const*] is NOT threadsafe
-            // Returns a NavMeshQuery valid for current thread only.
+            // Returns a NavMeshQuery valid for current thread only, taken from a thread local
+            // cache without any lock. It stays valid until the map is unloaded.
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
@@ -100,7 +101,6 @@ namespace MMAP
             ACE_RW_Mutex loadedMMaps_lock;
             MMapDataSet loadedModels;
             uint32 loadedTiles;
-            ACE_Thread_Mutex lockForModels;
     };
 
     // static class
@@ -551,6 +551,28 @@ void PathInfo::FillTargetAllowedFlags(Unit* target)
         m_targetAllowedFlags |= NAV_STEEP_SLOPES;
 }
 
+void PathInfo::CopyPathFrom(PathInfo const& other, Vector3 const& dest)
+{
+    m_polyLength = other.m_polyLength;
+    memcpy(m_pathPolyRefs, other.m_pathPolyRefs, sizeof(dtPolyRef) * m_polyLength);
+    m_pathPoints = other.m_pathPoints;
+    m_type = other.m_type;
+    m_endPosition = other.m_endPosition;
+    m_actualEndPosition = other.m_actualEndPosition;
+
+    float x, y, z;
+    m_sourceUnit->GetSafePosition(x, y, z, m_transport);
+    setStartPosition(Vector3(x, y, z));
+    if (!m_pathPoints.empty())
+        m_pathPoints[0] = m_startPosition;
+
+    if ((m_type & PATHFIND_NORMAL) && m_pathPoints.size() > 1 && m_endPosition != dest)
+    {
+        m_pathPoints[m_pathPoints.size() - 1] = dest;
+        setEndPosition(dest);
+    }
+}
+
 bool PathInfo::HaveTiles(const Vector3& p) const
 {
     if (m_transport)
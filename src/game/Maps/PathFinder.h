@@ -89,6 +89,9 @@ class PathInfo
         void SetTransport(Transport* t) { m_transport = t; }
         Transport* GetTransport() const { return m_transport; }
         void FillTargetAllowedFlags(Unit* target);
+        // Takes the path computed by another PathInfo (PathRequestService), starting from the current
+        // position of our unit. A normal path computed for a slightly different destination ends at ours.
+        void CopyPathFrom(PathInfo const& other, Vector3 const& dest);
     private:
 
         dtPolyRef       m_pathPolyRefs[MAX_PATH_LENGTH];   // array of detour polygon references
@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathRequestService.h"
+#include "MapManager.h"
+#include "PathFinder.h"
+#include "Creature.h"
+#include "World.h"
+#include "Timer.h"
+#include <cmath>
+
+enum PathRequestKeyFlags
+{
+    PATH_KEY_CAN_WALK           = 0x01,
+    PATH_KEY_CAN_SWIM           = 0x02,
+    PATH_KEY_CAN_FLY            = 0x04,
+    PATH_KEY_CREATURE           = 0x08,
+    PATH_KEY_IGNORE_PATHFINDING = 0x10,
+    PATH_KEY_FORCE_DEST         = 0x20,
+};
+
+std::size_t PathRequestKeyHash::operator()(PathRequestKey const& key) const
+{
+    std::size_t h = key.flags;
+    int32 const coords[6] = { key.startX, key.startY, key.startZ, key.destX, key.destY, key.destZ };
+    for (int32 c : coords)
+        h = h * 1000003 ^ std::size_t(uint32(c));
+    return h;
+}
+
+PathRequestService::PathRequestService() : m_tasks(sMapMgr.GetUpdatePool())
+{
+}
+
+PathRequestService::~PathRequestService()
+{
+    m_tasks.Wait();
+}
+
+PathRequestKey PathRequestService::MakeKey(Unit const* owner, Vector3 const& dest, bool forceDest)
+{
+    PathRequestKey key;
+    key.startX = int32(floor(owner->GetPositionX()));
+    key.startY = int32(floor(owner->GetPositionY()));
+    key.startZ = int32(floor(owner->GetPositionZ()));
+    key.destX = int32(floor(dest.x));
+    key.destY = int32(floor(dest.y));
+    key.destZ = int32(floor(dest.z));
+    key.flags = 0;
+    if (owner->CanWalk())
+        key.flags |= PATH_KEY_CAN_WALK;
+    if (owner->CanSwim())
+        key.flags |= PATH_KEY_CAN_SWIM;
+    if (owner->CanFly())
+        key.flags |= PATH_KEY_CAN_FLY;
+    if (owner->GetTypeId() == TYPEID_UNIT)
+        key.flags |= PATH_KEY_CREATURE;
+    if (owner->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING))
+        key.flags |= PATH_KEY_IGNORE_PATHFINDING;
+    if (forceDest)
+        key.flags |= PATH_KEY_FORCE_DEST;
+    return key;
+}
+
+PathRequestPtr PathRequestService::Request(Unit* owner, float x, float y, float z, bool forceDest)
+{
+    PathRequestPtr request = std::make_shared<PathRequest>(owner, Vector3(x, y, z), forceDest);
+    request->key = MakeKey(owner, request->dest, forceDest);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    PathCache::const_iterator it = m_cache.find(request->key);
+    if (it != m_cache.end())
+    {
+        request->result = it->second.path;
+        request->done.store(true, std::memory_order_release);
+    }
+    else
+        m_queue.push_back(request);
+    return request;
+}
+
+void PathRequestService::StartComputations(Map const* map)
+{
+    std::vector<PathRequestPtr> queue;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        queue.swap(m_queue);
+
+        uint32 now = WorldTimer::getMSTime();
+        uint32 cacheTime = sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_TIME);
+        for (PathCache::iterator it = m_cache.begin(); it != m_cache.end();)
+        {
+            if (WorldTimer::getMSTimeDiff(it->second.computedTime, now) >= cacheTime)
+                it = m_cache.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    for (PathRequestPtr& request : queue)
+    {
+        // Owner may be deleted once its request is cancelled
+        if (request->cancelled.load(std::memory_order_relaxed))
+            continue;
+        if (!request->owner->IsInWorld() || request->owner->FindMap() != map)
+        {
+            request->done.store(true, std::memory_order_release);
+            continue;
+        }
+        m_computing[request->key].push_back(request);
+    }
+
+    for (RequestsByKey::iterator it = m_computing.begin(); it != m_computing.end(); ++it)
+    {
+        std::vector<PathRequestPtr>* group = &it->second;
+        m_tasks.Run([group]()
+        {
+            PathRequest& first = *group->front();
+            std::shared_ptr<PathInfo> path = std::make_shared<PathInfo>(first.owner);
+            path->calculate(first.dest.x, first.dest.y, first.dest.z, first.forceDest);
+            for (PathRequestPtr const& request : *group)
+            {
+                request->result = path;
+                request->done.store(true, std::memory_order_release);
+            }
+        });
+    }
+}
+
+void PathRequestService::WaitComputations()
+{
+    if (m_computing.empty())
+        return;
+
+    m_tasks.Wait();
+
+    // 0 = no cache
+    if (sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_TIME))
+    {
+        uint32 now = WorldTimer::getMSTime();
+        std::lock_guard<std::mutex> guard(m_lock);
+        for (RequestsByKey::iterator it = m_computing.begin(); it != m_computing.end(); ++it)
+        {
+            CachedPath& cached = m_cache[it->first];
+            cached.path = it->second.front()->result;
+            cached.computedTime = now;
+        }
+    }
+    m_computing.clear();
+}
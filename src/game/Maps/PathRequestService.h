@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHREQUESTSERVICE_H
+#define MANGOS_PATHREQUESTSERVICE_H
+
+#include "Common.h"
+#include "ThreadPool.h"
+#include "G3D/Vector3.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Unit;
+class Map;
+class PathInfo;
+
+using G3D::Vector3;
+
+// Start and destination snapped to the yard, and what changes the path for the unit
+struct PathRequestKey
+{
+    int32 startX, startY, startZ;
+    int32 destX, destY, destZ;
+    uint32 flags;
+
+    bool operator==(PathRequestKey const& other) const
+    {
+        return startX == other.startX && startY == other.startY && startZ == other.startZ &&
+               destX == other.destX && destY == other.destY && destZ == other.destZ && flags == other.flags;
+    }
+};
+
+struct PathRequestKeyHash
+{
+    std::size_t operator()(PathRequestKey const& key) const;
+};
+
+struct PathRequest
+{
+    PathRequest(Unit* u, Vector3 const& d, bool force) : owner(u), dest(d), forceDest(force), done(false), cancelled(false) {}
+
+    Unit* const owner;
+    Vector3 const dest;
+    bool const forceDest;
+    PathRequestKey key;
+    // Set before 'done'. Null if the path could not be computed: the requester has to fall back on PathFinder.
+    // The PathInfo source unit may be another unit (or a deleted one), only use it with PathInfo::CopyPathFrom.
+    std::shared_ptr<PathInfo const> result;
+    std::atomic<bool> done;
+    // Set by the requester when it does not want the result anymore (generator deleted ...)
+    std::atomic<bool> cancelled;
+
+    bool IsDone() const { return done.load(std::memory_order_acquire); }
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+/**
+ * Computes the paths requested during the cells update of a map on the update pool,
+ * while the map sends the object updates. Identical requests (many mobs chasing the
+ * same target from the same place) share a single computation, and recent results
+ * are kept for mmap.async.CacheTime ms.
+ * Requests are only computed between StartComputations and WaitComputations: grids
+ * and navmesh tiles are not loaded nor unloaded there, and positions do not change.
+ */
+class PathRequestService
+{
+    public:
+        PathRequestService();
+        ~PathRequestService();
+
+        // Thread safe. The returned request may already be done (cached path).
+        PathRequestPtr Request(Unit* owner, float x, float y, float z, bool forceDest);
+
+        // Map update thread only
+        void StartComputations(Map const* map);
+        void WaitComputations();
+
+    private:
+        struct CachedPath
+        {
+            std::shared_ptr<PathInfo const> path;
+            uint32 computedTime;
+        };
+        typedef std::unordered_map<PathRequestKey, CachedPath, PathRequestKeyHash> PathCache;
+        typedef std::unordered_map<PathRequestKey, std::vector<PathRequestPtr>, PathRequestKeyHash> RequestsByKey;
+
+        static PathRequestKey MakeKey(Unit const* owner, Vector3 const& dest, bool forceDest);
+
+        std::mutex m_lock;                                  // m_queue and m_cache while requests can be made
+        std::vector<PathRequestPtr> m_queue;
+        PathCache m_cache;
+        RequestsByKey m_computing;
+        ThreadPool::TaskGroup m_tasks;
+};
+
+#endif
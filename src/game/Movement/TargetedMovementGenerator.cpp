@@ -95,13 +95,47 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T &owner)
     _targetOnTransport = transport;
     i_target->GetPosition(_targetLastX, _targetLastY, _targetLastZ, transport);
 
-    PathFinder path(&owner);
-
     // allow pets following their master to cheat while generating paths
     bool petFollowing = (isPet && owner.hasUnitState(UNIT_STAT_FOLLOW));
-    Movement::MoveSplineInit init(owner, "TargetedMovementGenerator");
+
+    // Creatures keep their current spline until the map computed the path
+    if (!transport && owner.GetTypeId() == TYPEID_UNIT &&
+            sWorld.getConfig(CONFIG_BOOL_MMAP_ENABLED) && sWorld.getConfig(CONFIG_BOOL_MMAP_ASYNC_PATHS))
+    {
+        if (m_pendingPath)
+            m_pendingPath->cancelled = true;
+        m_pendingPath = owner.GetMap()->GetPathRequests().Request(&owner, x, y, z, petFollowing);
+        i_recalculateTravel = false;
+        // Cached path
+        if (m_pendingPath->IsDone())
+            _launchPendingPath(owner);
+        return;
+    }
+
+    PathFinder path(&owner);
     path.SetTransport(transport);
     path.calculate(x, y, z, petFollowing);
+    _launchPath(owner, path, transport, petFollowing, losChecked, losResult);
+}
+
+template<class T, typename D>
+bool TargetedMovementGeneratorMedium<T, D>::_launchPendingPath(T &owner)
+{
+    PathRequestPtr request;
+    request.swap(m_pendingPath);
+    if (!request->result)
+        return false;
+
+    PathFinder path(&owner);
+    path.CopyPathFrom(*request->result, request->dest);
+    _launchPath(owner, path, NULL, request->forceDest, false, false);
+    return true;
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_launchPath(T &owner, PathFinder& path, Transport* transport, bool petFollowing, bool losChecked, bool losResult)
+{
+    Movement::MoveSplineInit init(owner, "TargetedMovementGenerator");
     i_reachable = path.getPathType() & PATHFIND_NORMAL;
     i_recalculateTravel = false;
     if (this->GetMovementGeneratorType() == CHASE_MOTION_TYPE && !transport && owner.HasDistanceCasterMovement())
@@ -302,13 +336,17 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T &owner, const uint32 & time
     }
     else if (i_recalculateTravel)
         owner.GetMotionMaster()->SetNeedAsyncUpdate();
+
+    if (m_pendingPath && m_pendingPath->IsDone())
+        owner.GetMotionMaster()->SetNeedAsyncUpdate();
     return true;
 }
 
 template<class T, typename D>
 void TargetedMovementGeneratorMedium<T, D>::UpdateAsync(T &owner, uint32 /*diff*/)
 {
-    if (!i_recalculateTravel)
+    bool pathComputed = m_pendingPath && m_pendingPath->IsDone();
+    if (!i_recalculateTravel && !pathComputed)
         return;
     // All these cases will be handled at next sync update
     if (!i_target.isValid() || !i_target->IsInWorld() || !owner.isAlive() || owner.hasUnitState(UNIT_STAT_CAN_NOT_MOVE | UNIT_STAT_CONTROLLED)
@@ -317,6 +355,12 @@ void TargetedMovementGeneratorMedium<T, D>::UpdateAsync(T &owner, uint32 /*diff*
             || owner.IsNoMovementSpellCasted())
         return;
 
+    if (pathComputed && !_launchPendingPath(owner))
+        i_recalculateTravel = true;
+    // Wait for the path requested by the previous move
+    if (!i_recalculateTravel || m_pendingPath)
+        return;
+
     _setTargetLocation(owner);
 }
 
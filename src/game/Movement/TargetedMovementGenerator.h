@@ -22,6 +22,7 @@
 #include "MovementGenerator.h"
 #include "FollowerReference.h"
 #include "PathFinder.h"
+#include "PathRequestService.h"
 #include "Unit.h"
 
 class MANGOS_DLL_SPEC TargetedMovementGeneratorBase
@@ -44,7 +45,11 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
             i_reachable(true), _targetLastX(0), _targetLastY(0), _targetLastZ(0), _targetOnTransport(false)
         {
         }
-        ~TargetedMovementGeneratorMedium() {}
+        ~TargetedMovementGeneratorMedium()
+        {
+            if (m_pendingPath)
+                m_pendingPath->cancelled = true;
+        }
 
     public:
         bool Update(T &, const uint32 &);
@@ -62,6 +67,9 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
 
     protected:
         void _setTargetLocation(T &);
+        void _launchPath(T &, PathFinder& path, Transport* transport, bool petFollowing, bool losChecked, bool losResult);
+        // Moves along the path computed by the map (mmap.async). Returns false if it could not be computed.
+        bool _launchPendingPath(T &);
 
         ShortTimeTracker i_recheckDistance;
         float i_offset;
@@ -73,6 +81,7 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
         float _targetLastY;
         float _targetLastZ;
         bool  _targetOnTransport;
+        PathRequestPtr m_pendingPath;
 };
 
 template<class T>
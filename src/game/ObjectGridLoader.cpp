@@ -97,15 +97,16 @@ public:
     uint32 i_corpses;
 };
 
-template<class T> void addUnitState(T* /*obj*/, CellPair const& /*cell_pair*/)
+template<class T> void addUnitState(T* /*obj*/, CellPair const& /*cell_pair*/, Map* /*map*/)
 {
 }
 
-template<> void addUnitState(Creature *obj, CellPair const& cell_pair)
+template<> void addUnitState(Creature *obj, CellPair const& cell_pair, Map* map)
 {
     Cell cell(cell_pair);
 
     obj->SetCurrentCell(cell);
+    map->GetCellPositionCache(cell)->Insert(obj);
 }
 
 template <typename T>
@@ -156,7 +157,7 @@ void LoadHelper(CellGuidSet const& guid_set, CellPair &cell, GridRefManager<T> &
 
         grid.AddGridObject(obj);
 
-        addUnitState(obj, cell);
+        addUnitState(obj, cell, map);
         obj->SetMap(map);
         obj->AddToWorld();
         if (obj->isActiveObject() && !map->IsUnloading())
@@ -189,7 +190,7 @@ void LoadHelper(CellCorpseSet const& cell_corpses, CellPair &cell, CorpseMapType
 
         grid.AddWorldObject(obj);
 
-        addUnitState(obj, cell);
+        addUnitState(obj, cell, map);
         obj->SetMap(map);
         obj->AddToWorld();
         if (obj->isActiveObject() && !map->IsUnloading())
@@ -3064,7 +3064,8 @@ void Creature::ProcessThreatList(ThreatListProcesser* f)
     if (!CanHaveThreatList())
         return;
 
-    ThreatList const& tList = getThreatManager().getThreatList();
+    // Copy: the processer may change the list
+    ThreatList const tList = getThreatManager().getThreatList();
     for (ThreatList::const_iterator i = tList.begin(); i != tList.end(); ++i)
     {
         Unit* target = GetMap()->GetUnit((*i)->getUnitGuid());
@@ -499,228 +499,279 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer * data, UpdateMask *
     {
         if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
         {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
-                IsActivateToQuest = true;
+            IsActivateToQuest = IsActivateToQuestFor(target);
 
             updateMask->SetBit(GAMEOBJECT_DYN_FLAGS);
             updateMask->SetBit(GAMEOBJECT_ANIMPROGRESS);
         }
     }
     if (isType(TYPEMASK_GAMEOBJECT))
-    {
-        target->m_visibleGobjsQuestAct_lock.acquire();
-        target->m_visibleGobjQuestActivated[GetObjectGuid()] = IsActivateToQuest;
-        target->m_visibleGobjsQuestAct_lock.release();
-    }
+        StoreQuestActivationFor(target, IsActivateToQuest);
 
     MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
 
     *data << (uint8)updateMask->GetBlockCount();
     data->append(updateMask->GetMask(), updateMask->GetLength());
 
-    // 2 specialized loops for speed optimization in non-unit case
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+        if (updateMask->GetBit(index))
+            *data << GetUpdateFieldValueFor(index, target, IsActivateToQuest);
+}
+
+bool Object::IsActivateToQuestFor(Player* target) const
+{
+    return ((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster();
+}
+
+void Object::StoreQuestActivationFor(Player* target, bool activated) const
+{
+    target->m_visibleGobjsQuestAct_lock.acquire();
+    target->m_visibleGobjQuestActivated[GetObjectGuid()] = activated;
+    target->m_visibleGobjsQuestAct_lock.release();
+}
+
+bool Object::IsViewerDependentUpdateField(uint16 index) const
+{
+    if (isType(TYPEMASK_UNIT))
+    {
+        switch (index)
+        {
+            case UNIT_NPC_FLAGS:
+            case UNIT_FIELD_FLAGS:
+            case UNIT_DYNAMIC_FLAGS:
+            case UNIT_FIELD_FACTIONTEMPLATE:
+            case UNIT_FIELD_HEALTH:
+            case UNIT_FIELD_MAXHEALTH:
+                return true;
+            default:
+                break;
+        }
+        return isType(TYPEMASK_PLAYER) && (index == PLAYER_FLAGS || index == PLAYER_TRACK_CREATURES || index == PLAYER_TRACK_RESOURCES);
+    }
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return index == GAMEOBJECT_DYN_FLAGS;
+    return index == CORPSE_FIELD_DYNAMIC_FLAGS;
+}
+
+uint32 Object::GetUpdateFieldValueFor(uint16 index, Player* target, bool IsActivateToQuest) const
+{
     if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        if (index == UNIT_NPC_FLAGS)
         {
-            if (updateMask->GetBit(index))
+            uint32 appendValue = m_uint32Values[index];
+
+            if (GetTypeId() == TYPEID_UNIT)
             {
-                if (index == UNIT_NPC_FLAGS)
+                if (appendValue & UNIT_NPC_FLAG_TRAINER)
                 {
-                    uint32 appendValue = m_uint32Values[index];
-
-                    if (GetTypeId() == TYPEID_UNIT)
-                    {
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~UNIT_NPC_FLAG_TRAINER;
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
-                    }
-
-                    *data << uint32(appendValue);
+                    if (!((Creature*)this)->IsTrainerOf(target, false))
+                        appendValue &= ~UNIT_NPC_FLAG_TRAINER;
                 }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+
+                if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
                 {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+                    if (target->getClass() != CLASS_HUNTER)
+                        appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
                 }
+            }
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
-                    *data << uint32(m_floatValues[index]);
-                // Video maker - hide unit name, etc ...
-                else if (index == UNIT_FIELD_FLAGS && target->HasOption(PLAYER_VIDEO_MODE) && target != this)
-                    *data << (m_uint32Values[index] | UNIT_FLAG_NOT_SELECTABLE);
-                // Gamemasters should be always able to select units and view auras
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                    *data << ((m_uint32Values[index] | UNIT_FLAG_AURAS_VISIBLE) & ~UNIT_FLAG_NOT_SELECTABLE);
-                // hide lootable animation for unallowed players
-                else if (index == UNIT_DYNAMIC_FLAGS)
-                {
-                    uint32 dynamicFlags = m_uint32Values[index];
+            return appendValue;
+        }
+        // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+        else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
+        {
+            // convert from float to uint32 and send
+            return uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+        }
 
-                    if (Creature const* creature = ToCreature())
-                    {
-                        if (creature->HasLootRecipient())
-                        {
-                            if (creature->IsTappedBy(target))
-                                dynamicFlags |= (UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-                            else
-                            {
-                                dynamicFlags |= UNIT_DYNFLAG_TAPPED;
-                                dynamicFlags &= ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            }
-                        }
-                        else
-                        {
-                            dynamicFlags &= ~UNIT_DYNFLAG_TAPPED;
-                            dynamicFlags &= ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                        }
-
-                        if (!target->isAllowedToLoot(creature))
-                            dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
-                    }
-                    *data << dynamicFlags;
-                }
-                // RAID ally-horde - Faction
-                else if (index == UNIT_FIELD_FACTIONTEMPLATE)
-                {
-                    Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
-                    bool forceFriendly = false;
-                    if (owner)
-                    {
-                        FactionTemplateEntry const *ft1, *ft2;
-                        ft1 = owner->getFactionTemplateEntry();
-                        ft2 = target->getFactionTemplateEntry();
-                        if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2) && owner->IsInSameRaidWith(target))
-                            if (owner->IsInInterFactionMode() && target->IsInInterFactionMode())
-                                forceFriendly = true;
-                    }
-                    uint32 faction = m_uint32Values[index];
-                    if (forceFriendly)
-                        faction = target->getFaction();
+        // there are some float values which may be negative or can't get negative due to other checks
+        else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
+                 (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+                 (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+                 (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
+            return uint32(m_floatValues[index]);
+        // Video maker - hide unit name, etc ...
+        else if (index == UNIT_FIELD_FLAGS && target->HasOption(PLAYER_VIDEO_MODE) && target != this)
+            return m_uint32Values[index] | UNIT_FLAG_NOT_SELECTABLE;
+        // Gamemasters should be always able to select units and view auras
+        else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+            return (m_uint32Values[index] | UNIT_FLAG_AURAS_VISIBLE) & ~UNIT_FLAG_NOT_SELECTABLE;
+        // hide lootable animation for unallowed players
+        else if (index == UNIT_DYNAMIC_FLAGS)
+        {
+            uint32 dynamicFlags = m_uint32Values[index];
 
-                    *data << uint32(faction);
-                }
-                // RAID ally-horde : pas de flag FFA
-                else if (index == PLAYER_FLAGS && (m_uint32Values[index] & PLAYER_FLAGS_FFA_PVP))
+            if (Creature const* creature = ToCreature())
+            {
+                if (creature->HasLootRecipient())
                 {
-                    Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
-                    if (owner && owner != target && owner->IsInSameRaidWith(target))
-                        *data << uint32(m_uint32Values[index] & ~PLAYER_FLAGS_FFA_PVP);
+                    if (creature->IsTappedBy(target))
+                        dynamicFlags |= (UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
                     else
-                        *data << uint32(m_uint32Values[index]);
-                }
-                // Hide real health value. Send a percent instead.
-                else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
-                {
-                    Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
-                    if (owner && owner->IsInSameRaidWith(target))
-                        *data << m_uint32Values[index];
-                    else // Hide
                     {
-                        if (index == UNIT_FIELD_MAXHEALTH)
-                            *data << uint32(100);
-                        else
-                        {
-                            uint32 pct = 0;
-                            if (m_uint32Values[UNIT_FIELD_HEALTH])
-                            {
-                                pct = uint32((m_uint32Values[UNIT_FIELD_HEALTH] * 100.0f) / m_uint32Values[UNIT_FIELD_MAXHEALTH]);
-                                if (pct > 100)
-                                    pct = 100;
-                                if (!pct)
-                                    pct = 1;
-                            }
-                            *data << pct;
-                        }
+                        dynamicFlags |= UNIT_DYNFLAG_TAPPED;
+                        dynamicFlags &= ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
                     }
                 }
-                else if (target == this && (index == PLAYER_TRACK_CREATURES || index == PLAYER_TRACK_RESOURCES))
-                {
-                    //if (WardenInterface* base = target->GetSession()->GetWarden())
-                        //base->TrackingUpdateSent(index, m_uint32Values[index]);
-                    *data << m_uint32Values[index];
-                }
                 else
                 {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
+                    dynamicFlags &= ~UNIT_DYNFLAG_TAPPED;
+                    dynamicFlags &= ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
                 }
+
+                if (!target->isAllowedToLoot(creature))
+                    dynamicFlags &= ~UNIT_DYNFLAG_LOOTABLE;
+            }
+            return dynamicFlags;
+        }
+        // RAID ally-horde - Faction
+        else if (index == UNIT_FIELD_FACTIONTEMPLATE)
+        {
+            Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
+            bool forceFriendly = false;
+            if (owner)
+            {
+                FactionTemplateEntry const *ft1, *ft2;
+                ft1 = owner->getFactionTemplateEntry();
+                ft2 = target->getFactionTemplateEntry();
+                if (ft1 && ft2 && !ft1->IsFriendlyTo(*ft2) && owner->IsInSameRaidWith(target))
+                    if (owner->IsInInterFactionMode() && target->IsInInterFactionMode())
+                        forceFriendly = true;
+            }
+            uint32 faction = m_uint32Values[index];
+            if (forceFriendly)
+                faction = target->getFaction();
+
+            return faction;
+        }
+        // RAID ally-horde : pas de flag FFA
+        else if (index == PLAYER_FLAGS && (m_uint32Values[index] & PLAYER_FLAGS_FFA_PVP))
+        {
+            Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
+            if (owner && owner != target && owner->IsInSameRaidWith(target))
+                return m_uint32Values[index] & ~PLAYER_FLAGS_FFA_PVP;
+            return m_uint32Values[index];
+        }
+        // Hide real health value. Send a percent instead.
+        else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
+        {
+            Player* owner = ((Unit*)this)->GetCharmerOrOwnerPlayerOrPlayerItself();
+            if (owner && owner->IsInSameRaidWith(target))
+                return m_uint32Values[index];
+            // Hide
+            if (index == UNIT_FIELD_MAXHEALTH)
+                return 100;
+
+            uint32 pct = 0;
+            if (m_uint32Values[UNIT_FIELD_HEALTH])
+            {
+                pct = uint32((m_uint32Values[UNIT_FIELD_HEALTH] * 100.0f) / m_uint32Values[UNIT_FIELD_MAXHEALTH]);
+                if (pct > 100)
+                    pct = 100;
+                if (!pct)
+                    pct = 1;
             }
+            return pct;
+        }
+        else if (target == this && (index == PLAYER_TRACK_CREATURES || index == PLAYER_TRACK_RESOURCES))
+        {
+            //if (WardenInterface* base = target->GetSession()->GetWarden())
+                //base->TrackingUpdateSent(index, m_uint32Values[index]);
+            return m_uint32Values[index];
         }
     }
     else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        if (index == GAMEOBJECT_DYN_FLAGS)
         {
-            if (updateMask->GetBit(index))
+            if (!IsActivateToQuest)
+                return 0;                                   // disable quest object
+
+            switch (((GameObject*)this)->GetGoType())
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
-                {
-                    if (IsActivateToQuest)
-                    {
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                            case GAMEOBJECT_TYPE_CHEST:
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(0);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown, not happen.
-                                break;
-                        }
-                    }
-                    else
-                        *data << uint32(0);                 // disable quest object
-                }
-                else
-                    *data << m_uint32Values[index];         // other cases
+                case GAMEOBJECT_TYPE_QUESTGIVER:
+                case GAMEOBJECT_TYPE_CHEST:
+                case GAMEOBJECT_TYPE_GENERIC:
+                case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                case GAMEOBJECT_TYPE_GOOBER:
+                    return GO_DYNFLAG_LO_ACTIVATE;          // uint16 flags, uint16 0
+                default:
+                    return 0;                               // unknown, not happen.
             }
         }
     }
-    else                                                    // other objects case (no special index checks)
+    else if (index == CORPSE_FIELD_DYNAMIC_FLAGS)           // other objects case
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        uint32 dynFlags = m_uint32Values[CORPSE_FIELD_DYNAMIC_FLAGS];
+        if (Corpse const* corpse = ToCorpse())
         {
-            if (updateMask->GetBit(index))
-            {
-                if (index == CORPSE_FIELD_DYNAMIC_FLAGS)
-                {
-                    uint32 dynFlags = m_uint32Values[CORPSE_FIELD_DYNAMIC_FLAGS];
-                    if (Corpse const* corpse = ToCorpse())
-                    {
-                        const Loot* loot = &corpse->loot;
-                        if (loot->isLooted()) // nothing to loot or everything looted.
-                            dynFlags &= ~CORPSE_DYNFLAG_LOOTABLE;
-                        if (dynFlags & CORPSE_DYNFLAG_LOOTABLE)
-                            if (corpse->IsFriendlyTo(target))
-                                dynFlags &= ~CORPSE_DYNFLAG_LOOTABLE;
-                    }
-                    *data << dynFlags;
-                }
-                else
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
-            }
+            const Loot* loot = &corpse->loot;
+            if (loot->isLooted()) // nothing to loot or everything looted.
+                dynFlags &= ~CORPSE_DYNFLAG_LOOTABLE;
+            if (dynFlags & CORPSE_DYNFLAG_LOOTABLE)
+                if (corpse->IsFriendlyTo(target))
+                    dynFlags &= ~CORPSE_DYNFLAG_LOOTABLE;
         }
+        return dynFlags;
     }
+
+    // send in current format (float as float, uint32 as uint32)
+    return m_uint32Values[index];
+}
+
+SharedUpdateBlockPtr Object::BuildSharedValuesUpdateBlock() const
+{
+    std::shared_ptr<SharedUpdateBlock> block = std::make_shared<SharedUpdateBlock>();
+    ByteBuffer& buf = block->data;
+
+    buf << uint8(UPDATETYPE_VALUES);
+    buf << GetPackGUID();
+
+    UpdateMask updateMask;
+    updateMask.SetCount(m_valuesCount);
+    // Mask as seen by any player but the object itself
+    _SetUpdateBits(&updateMask, nullptr);
+    if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+    {
+        updateMask.SetBit(GAMEOBJECT_DYN_FLAGS);
+        updateMask.SetBit(GAMEOBJECT_ANIMPROGRESS);
+    }
+
+    buf << (uint8)updateMask.GetBlockCount();
+    buf.append(updateMask.GetMask(), updateMask.GetLength());
+
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+    {
+        if (!updateMask.GetBit(index))
+            continue;
+        if (IsViewerDependentUpdateField(index))
+        {
+            block->viewerFields.push_back(SharedUpdateBlock::ViewerField(buf.wpos(), index));
+            buf << uint32(0);
+        }
+        else
+            buf << GetUpdateFieldValueFor(index, nullptr, false); // no target needed, converts the float stored fields
+    }
+    return block;
+}
+
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData *data, Player *target, SharedUpdateBlockPtr const& shared) const
+{
+    bool IsActivateToQuest = false;
+    if (isType(TYPEMASK_GAMEOBJECT))
+    {
+        if (!((GameObject*)this)->IsTransport())
+            IsActivateToQuest = IsActivateToQuestFor(target);
+        StoreQuestActivationFor(target, IsActivateToQuest);
+    }
+
+    std::vector<uint32> viewerValues;
+    viewerValues.reserve(shared->viewerFields.size());
+    for (std::vector<SharedUpdateBlock::ViewerField>::const_iterator it = shared->viewerFields.begin(); it != shared->viewerFields.end(); ++it)
+        viewerValues.push_back(GetUpdateFieldValueFor(it->index, target, IsActivateToQuest));
+
+    data->AddUpdateBlock(shared, std::move(viewerValues));
 }
 
 void Object::ClearUpdateMask(bool remove)
@@ -1022,6 +1073,20 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
     BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
 }
 
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, SharedUpdateBlockPtr const& shared)
+{
+    UpdateDataMapType::iterator iter = update_players.find(pl);
+
+    if (iter == update_players.end())
+    {
+        std::pair<UpdateDataMapType::iterator, bool> p = update_players.insert(UpdateDataMapType::value_type(pl, UpdateData()));
+        MANGOS_ASSERT(p.second);
+        iter = p.first;
+    }
+
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, shared);
+}
+
 void Object::AddToClientUpdateList()
 {
     sLog.outError("Unexpected call of Object::AddToClientUpdateList for object (TypeId: %u Update fields: %u)", GetTypeId(), m_valuesCount);
@@ -1082,7 +1147,8 @@ void Object::ExecuteDelayedActions()
 }
 
 WorldObject::WorldObject()
-    : m_isActiveObject(false), m_currMap(nullptr), m_mapId(0), m_InstanceId(0)
+    : m_isActiveObject(false), m_currMap(nullptr), m_mapId(0), m_InstanceId(0),
+      m_positionCache(nullptr), m_positionCacheIndex(0)
 {
     // Phasing
     worldMask = WORLD_DEFAULT_OBJECT;
@@ -1091,6 +1157,12 @@ WorldObject::WorldObject()
     m_movementInfo.time = WorldTimer::getMSTime();
 }
 
+WorldObject::~WorldObject()
+{
+    // Deleted with its grid, like the grid container references
+    CellPositionCache::Remove(this);
+}
+
 void WorldObject::CleanupsBeforeDelete()
 {
     RemoveFromWorld();
@@ -1115,6 +1187,7 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
 
     m_movementInfo.ChangePosition(x, y, z, orientation);
     m_movementInfo.UpdateTime(WorldTimer::getMSTime());
+    RefreshPositionCache();
     /*if (Transport* t = GetTransport())
     {
         t->CalculatePassengerOffset(x, y, z);
@@ -1129,6 +1202,12 @@ void WorldObject::Relocate(float x, float y, float z)
     Relocate(x, y, z, GetOrientation());
 }
 
+void WorldObject::RefreshPositionCache()
+{
+    if (m_positionCache)
+        m_positionCache->Refresh(this);
+}
+
 void WorldObject::SetOrientation(float orientation)
 {
     m_position.o = orientation;
@@ -2361,11 +2440,18 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter->getSource()->GetOwner();
             if (owner != &i_object && owner->IsInVisibleList_Unsafe(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+            {
+                // Serialized once, then only the viewer dependent fields are computed for each player
+                if (!i_sharedBlock)
+                    i_sharedBlock = i_object.BuildSharedValuesUpdateBlock();
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, i_sharedBlock);
+            }
         }
     }
 
     template<class SKIP> void Visit(GridRefManager<SKIP> &) {}
+
+    SharedUpdateBlockPtr i_sharedBlock;
 };
 
 void WorldObject::BuildUpdateData(UpdateDataMapType & update_players)
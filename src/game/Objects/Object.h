@@ -26,6 +26,7 @@
 #include "UpdateData.h"
 #include "ObjectGuid.h"
 #include "Camera.h"
+#include "Utilities/DirtyList.h"
 #include "SpellEntry.h"
 
 #include <set>
@@ -76,6 +77,7 @@ class InstanceData;
 class TerrainInfo;
 class ZoneScript;
 class Transport;
+class CellPositionCache;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
 
@@ -347,15 +349,22 @@ class MANGOS_DLL_SPEC Object
         void ExecuteDelayedActions();
 
         void BuildValuesUpdateBlockForPlayer( UpdateData *data, Player *target ) const;
+        void BuildValuesUpdateBlockForPlayer( UpdateData *data, Player *target, SharedUpdateBlockPtr const& shared ) const;
+        // Values update shared by all viewers but the object itself (see SharedUpdateBlock)
+        SharedUpdateBlockPtr BuildSharedValuesUpdateBlock() const;
         void BuildOutOfRangeUpdateBlock( UpdateData *data ) const;
         void BuildMovementUpdateBlock( UpdateData * data, uint8 flags = 0 ) const;
 
         void BuildMovementUpdate(ByteBuffer * data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer *data, UpdateMask *updateMask, Player *target ) const;
         void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players);
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, SharedUpdateBlockPtr const& shared);
 
         virtual void DestroyForPlayer( Player *target ) const;
 
+        // Position in Map::i_objectsToClientUpdate
+        DirtyListElement& GetClientUpdateListElement() { return m_clientUpdateListElement; }
+
         const int32& GetInt32Value( uint16 index ) const
         {
             MANGOS_ASSERT( index < m_valuesCount || PrintIndexError( index , false) );
@@ -593,6 +602,13 @@ class MANGOS_DLL_SPEC Object
 
         virtual void _SetCreateBits(UpdateMask *updateMask, Player *target) const;
 
+        // Value of an update field as sent to 'target', which may be null if the field is not viewer dependent
+        uint32 GetUpdateFieldValueFor(uint16 index, Player* target, bool IsActivateToQuest) const;
+        // True if GetUpdateFieldValueFor() may return a different value depending on the target
+        bool IsViewerDependentUpdateField(uint16 index) const;
+        bool IsActivateToQuestFor(Player* target) const;
+        void StoreQuestActivationFor(Player* target, bool activated) const;
+
         uint16 m_objectType;
 
         uint8 m_objectTypeId;
@@ -615,6 +631,7 @@ class MANGOS_DLL_SPEC Object
 
     private:
         bool m_inWorld;
+        DirtyListElement m_clientUpdateListElement;
 
         PackedGuid m_PackGUID;
 
@@ -629,6 +646,7 @@ struct WorldObjectChangeAccumulator;
 class MANGOS_DLL_SPEC WorldObject : public Object
 {
     friend struct WorldObjectChangeAccumulator;
+    friend class CellPositionCache;
 
     public:
 
@@ -659,7 +677,7 @@ class MANGOS_DLL_SPEC WorldObject : public Object
                 WorldObject * const m_obj;
         };
 
-        virtual ~WorldObject ( ) {}
+        virtual ~WorldObject ( );
 
         virtual void Update(uint32 /*update_diff*/, uint32 /*time_diff*/);
 
@@ -667,6 +685,8 @@ class MANGOS_DLL_SPEC WorldObject : public Object
 
         void Relocate(float x, float y, float z, float orientation);
         void Relocate(float x, float y, float z);
+        // To call when the position is changed without Relocate, or when the bounding radius changes
+        void RefreshPositionCache();
 
         void SetOrientation(float orientation);
 
@@ -880,6 +900,9 @@ class MANGOS_DLL_SPEC WorldObject : public Object
 
         ViewPoint& GetViewPoint() { return m_viewPoint; }
 
+        // Position in Map::i_unitsRelocated (units only)
+        DirtyListElement& GetRelocatedListElement() { return m_relocatedListElement; }
+
         // WorldMask
         uint32 worldMask;
         virtual void SetWorldMask(uint32 newMask);
@@ -912,6 +935,10 @@ class MANGOS_DLL_SPEC WorldObject : public Object
         Position m_position;
 
         ViewPoint m_viewPoint;
+        DirtyListElement m_relocatedListElement;
+
+        CellPositionCache* m_positionCache;                 // units only, cell where the position is indexed
+        uint32 m_positionCacheIndex;
 
         WorldUpdateCounter m_updateTracker;
 };
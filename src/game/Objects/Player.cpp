@@ -557,6 +557,7 @@ Player::Player(WorldSession *session) : Unit(),
     i_AI = NULL;
     _playerOptions = 0x0;
     m_DbSaveDisabled = false;
+    m_savedRowsKnown = false;
 
     m_lastFromClientCastedSpellID = 0;
 
@@ -1275,9 +1276,16 @@ void Player::Update(uint32 update_diff, uint32 p_time)
     {
         if (update_diff >= m_nextSave)
         {
-            // m_nextSave reseted in SaveToDB call
-            SaveToDB();
-            DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            // let the character database workers catch up before queuing more saves
+            uint32 maxQueue = sWorld.getConfig(CONFIG_UINT32_SAVE_MAX_DATABASE_QUEUE);
+            if (maxQueue && CharacterDatabase.GetAsyncQueueSize() > maxQueue)
+                m_nextSave = urand(1 * IN_MILLISECONDS, 5 * IN_MILLISECONDS);
+            else
+            {
+                // m_nextSave reseted in SaveToDB call
+                SaveToDB();
+                DETAIL_LOG("Player '%s' (GUID: %u) saved", GetName(), GetGUIDLow());
+            }
         }
         else
             m_nextSave -= update_diff;
@@ -1362,6 +1370,7 @@ void Player::Update(uint32 update_diff, uint32 p_time)
             m_position.y = y;
             m_position.z = z;
             m_position.o = o;
+            RefreshPositionCache();
             /*
             if (Unit* c = SummonCreature(1, x, y, z, o, TEMPSUMMON_TIMED_DESPAWN, 5000))
             {
@@ -1412,6 +1421,7 @@ void Player::RelocateToLastClientPosition()
         m_position.y = y;
         m_position.z = z;
         m_position.o = o;
+        RefreshPositionCache();
     }
 }
 
@@ -3620,29 +3630,57 @@ void Player::_LoadSpellCooldowns(QueryResult *result)
 
 void Player::_SaveSpellCooldowns()
 {
+    static SqlStatementID deleteSpellCooldowns ;
     static SqlStatementID deleteSpellCooldown ;
-    static SqlStatementID insertSpellCooldown ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
 
     time_t curTime = time(NULL);
     time_t infTime = curTime + infinityCooldownDelayCheck;
 
     // remove outdated and save active
+    SpellCooldowns cooldowns;
     for (SpellCooldowns::iterator itr = m_spellCooldowns.begin(); itr != m_spellCooldowns.end();)
     {
         if (itr->second.end <= curTime)
             m_spellCooldowns.erase(itr++);
-        else if (itr->second.end <= infTime)                // not save locked cooldowns, it will be reset or set at reload
+        else
         {
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, spell, item, time, cattime) VALUES( ?, ?, ?, ?, ?)");
-            stmt.PExecute(GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end), uint64(itr->second.categoryEnd));
+            if (itr->second.end <= infTime)                 // not save locked cooldowns, it will be reset or set at reload
+                cooldowns.insert(*itr);
             ++itr;
         }
-        else
-            ++itr;
     }
+
+    if (!m_savedRowsKnown)
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldowns, "DELETE FROM character_spell_cooldown WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+    }
+    else
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ? AND spell = ?");
+        for (SpellCooldowns::const_iterator itr = m_savedSpellCooldowns.begin(); itr != m_savedSpellCooldowns.end(); ++itr)
+            if (cooldowns.find(itr->first) == cooldowns.end())
+                stmt.PExecute(GetGUIDLow(), itr->first);
+    }
+
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_spell_cooldown (guid, spell, item, time, cattime)",
+            "ON DUPLICATE KEY UPDATE item = VALUES(item), time = VALUES(time), cattime = VALUES(cattime)");
+    for (SpellCooldowns::const_iterator itr = cooldowns.begin(); itr != cooldowns.end(); ++itr)
+    {
+        if (m_savedRowsKnown)
+        {
+            SpellCooldowns::const_iterator saved = m_savedSpellCooldowns.find(itr->first);
+            if (saved != m_savedSpellCooldowns.end() && saved->second.end == itr->second.end &&
+                saved->second.categoryEnd == itr->second.categoryEnd && saved->second.itemid == itr->second.itemid)
+                continue;
+        }
+
+        batch.NewRow() << GetGUIDLow() << ", " << itr->first << ", " << itr->second.itemid << ", "
+                       << uint64(itr->second.end) << ", " << uint64(itr->second.categoryEnd);
+    }
+    batch.Flush();
+
+    m_savedSpellCooldowns.swap(cooldowns);
 }
 
 uint32 Player::resetTalentsCost() const
@@ -4052,6 +4090,7 @@ void Player::DeleteFromDB(ObjectGuid playerguid, uint32 accountId, bool updateRe
     }
 
     uint32 lowguid = playerguid.GetCounter();
+    SqlAsyncKey asyncKey(lowguid);
 
     // convert corpse to bones if exist (to prevent exiting Corpse in World without DB entry)
     // bones will be deleted by corpse/bones deleting thread shortly
@@ -15193,6 +15232,8 @@ void Player::SaveToDB(bool online, bool force)
     //DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
     //outDebugStatsValues();
 
+    // everything saved below stays ordered with the other requests about this character
+    SqlAsyncKey asyncKey(GetGUIDLow());
     CharacterDatabase.BeginTransaction();
 
     m_honorMgr.Update();
@@ -15357,6 +15398,7 @@ void Player::SaveToDB(bool online, bool force)
     GetSession()->SaveTutorialsData();                      // changed only while character in game
 
     CharacterDatabase.CommitTransaction();
+    m_savedRowsKnown = true;
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
@@ -15391,46 +15433,69 @@ void Player::SaveGoldToDB()
 void Player::_SaveAuras()
 {
     static SqlStatementID deleteAuras ;
-    static SqlStatementID insertAuras ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
-
-    if (auraHolders.empty())
-        return;
-
-    stmt = CharacterDatabase.CreateStatement(insertAuras, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
-            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    static SqlStatementID deleteAura ;
 
+    SavedAuraMap auras;
     AuraSaveStruct s;
+    SpellAuraHolderMap const& auraHolders = GetSpellAuraHolderMap();
     for (SpellAuraHolderMap::const_iterator itr = auraHolders.begin(); itr != auraHolders.end(); ++itr)
+        if (SaveAura(itr->second, s))
+            auras[SavedAuraKey(s.caster_guid.GetRawValue(), s.item_lowguid, s.spellid)] = s;
+
+    if (!m_savedRowsKnown)
     {
-        SpellAuraHolder *holder = itr->second;
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAuras, "DELETE FROM character_aura WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+    }
+    else
+    {
+        SqlStatement stmt = CharacterDatabase.CreateStatement(deleteAura, "DELETE FROM character_aura WHERE guid = ? AND caster_guid = ? AND item_guid = ? AND spell = ?");
+        for (SavedAuraMap::const_iterator itr = m_savedAuras.begin(); itr != m_savedAuras.end(); ++itr)
+            if (auras.find(itr->first) == auras.end())
+                stmt.PExecute(GetGUIDLow(), std::get<0>(itr->first), std::get<1>(itr->first), std::get<2>(itr->first));
+    }
 
-        if (!SaveAura(holder, s))
-            continue;
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_aura (guid, caster_guid, item_guid, spell, stackcount, remaincharges, "
+            "basepoints0, basepoints1, basepoints2, periodictime0, periodictime1, periodictime2, maxduration, remaintime, effIndexMask)",
+            "ON DUPLICATE KEY UPDATE stackcount = VALUES(stackcount), remaincharges = VALUES(remaincharges), "
+            "basepoints0 = VALUES(basepoints0), basepoints1 = VALUES(basepoints1), basepoints2 = VALUES(basepoints2), "
+            "periodictime0 = VALUES(periodictime0), periodictime1 = VALUES(periodictime1), periodictime2 = VALUES(periodictime2), "
+            "maxduration = VALUES(maxduration), remaintime = VALUES(remaintime), effIndexMask = VALUES(effIndexMask)");
 
-        stmt.addUInt32(GetGUIDLow());
-        stmt.addUInt64(s.caster_guid.GetRawValue());
-        stmt.addUInt32(s.item_lowguid);
-        stmt.addUInt32(s.spellid);
-        stmt.addUInt32(s.stackcount);
-        stmt.addUInt8(s.remaincharges);
+    for (SavedAuraMap::const_iterator itr = auras.begin(); itr != auras.end(); ++itr)
+    {
+        // most auras did not change since the last save (no duration, or not applied/refreshed)
+        if (m_savedRowsKnown)
+        {
+            SavedAuraMap::const_iterator saved = m_savedAuras.find(itr->first);
+            if (saved != m_savedAuras.end() && saved->second == itr->second)
+                continue;
+        }
 
+        AuraSaveStruct const& aura = itr->second;
+        std::ostringstream& row = batch.NewRow();
+        row << GetGUIDLow() << ", " << aura.caster_guid.GetRawValue() << ", " << aura.item_lowguid << ", " << aura.spellid << ", "
+            << aura.stackcount << ", " << uint32(uint8(aura.remaincharges));
         for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-            stmt.addInt32(s.damage[i]);
-
+            row << ", " << aura.damage[i];
         for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
-            stmt.addUInt32(s.periodicTime[i]);
-
-        stmt.addInt32(s.maxduration);
-        stmt.addInt32(s.remaintime);
-        stmt.addUInt32(s.effIndexMask);
-        stmt.Execute();
+            row << ", " << aura.periodicTime[i];
+        row << ", " << aura.maxduration << ", " << aura.remaintime << ", " << aura.effIndexMask;
     }
+    batch.Flush();
+
+    m_savedAuras.swap(auras);
+}
+
+bool AuraSaveStruct::operator==(AuraSaveStruct const& other) const
+{
+    for (uint32 i = 0; i < MAX_EFFECT_INDEX; ++i)
+        if (damage[i] != other.damage[i] || periodicTime[i] != other.periodicTime[i])
+            return false;
+
+    return caster_guid == other.caster_guid && item_lowguid == other.item_lowguid && spellid == other.spellid &&
+           stackcount == other.stackcount && remaincharges == other.remaincharges && maxduration == other.maxduration &&
+           remaintime == other.remaintime && effIndexMask == other.effIndexMask;
 }
 
 bool Player::SaveAura(SpellAuraHolder* holder, AuraSaveStruct& saveStruct)
@@ -15595,9 +15660,11 @@ void Player::_SaveInventory()
 
 void Player::_SaveQuestStatus()
 {
-    static SqlStatementID insertQuestStatus ;
-
-    static SqlStatementID updateQuestStatus ;
+    // new and changed quests are written together, one statement for many rows
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4)",
+        "ON DUPLICATE KEY UPDATE status = VALUES(status), rewarded = VALUES(rewarded), explored = VALUES(explored), timer = VALUES(timer), "
+        "mobcount1 = VALUES(mobcount1), mobcount2 = VALUES(mobcount2), mobcount3 = VALUES(mobcount3), mobcount4 = VALUES(mobcount4), "
+        "itemcount1 = VALUES(itemcount1), itemcount2 = VALUES(itemcount2), itemcount3 = VALUES(itemcount3), itemcount4 = VALUES(itemcount4)");
 
     // we don't need transactions here.
     for (QuestStatusMap::iterator i = mQuestStatus.begin(); i != mQuestStatus.end();)
@@ -15615,39 +15682,15 @@ void Player::_SaveQuestStatus()
         switch (i->second.uState)
         {
             case QUEST_NEW :
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insertQuestStatus, "INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
-                                    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(i->first);
-                stmt.addUInt8(i->second.m_status);
-                stmt.addUInt8(i->second.m_rewarded);
-                stmt.addUInt8(i->second.m_explored);
-                stmt.addUInt64(uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()));
-                for (int k = 0; k < QUEST_OBJECTIVES_COUNT; ++k)
-                    stmt.addUInt32(i->second.m_creatureOrGOcount[k]);
-                for (int k = 0; k < QUEST_OBJECTIVES_COUNT; ++k)
-                    stmt.addUInt32(i->second.m_itemcount[k]);
-                stmt.Execute();
-            }
-            break;
             case QUEST_CHANGED :
             {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(updateQuestStatus, "UPDATE character_queststatus SET status = ?,rewarded = ?,explored = ?,timer = ?,"
-                                    "mobcount1 = ?,mobcount2 = ?,mobcount3 = ?,mobcount4 = ?,itemcount1 = ?,itemcount2 = ?,itemcount3 = ?,itemcount4 = ?  WHERE guid = ? AND quest = ?");
-
-                stmt.addUInt8(i->second.m_status);
-                stmt.addUInt8(i->second.m_rewarded);
-                stmt.addUInt8(i->second.m_explored);
-                stmt.addUInt64(uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()));
+                std::ostringstream& row = batch.NewRow();
+                row << GetGUIDLow() << ", " << i->first << ", " << uint32(i->second.m_status) << ", " << uint32(i->second.m_rewarded ? 1 : 0) << ", "
+                    << uint32(i->second.m_explored ? 1 : 0) << ", " << uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime());
                 for (int k = 0; k < QUEST_OBJECTIVES_COUNT; ++k)
-                    stmt.addUInt32(i->second.m_creatureOrGOcount[k]);
+                    row << ", " << i->second.m_creatureOrGOcount[k];
                 for (int k = 0; k < QUEST_OBJECTIVES_COUNT; ++k)
-                    stmt.addUInt32(i->second.m_itemcount[k]);
-                stmt.addUInt32(GetGUIDLow());
-                stmt.addUInt32(i->first);
-                stmt.Execute();
+                    row << ", " << i->second.m_itemcount[k];
             }
             break;
             case QUEST_UNCHANGED:
@@ -15656,13 +15699,15 @@ void Player::_SaveQuestStatus()
         i->second.uState = QUEST_UNCHANGED;
         ++i;
     }
+    batch.Flush();
 }
 
 void Player::_SaveSkills()
 {
     static SqlStatementID delSkills ;
-    static SqlStatementID insSkills ;
-    static SqlStatementID updSkills ;
+
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_skills (guid, skill, value, max)",
+        "ON DUPLICATE KEY UPDATE value = VALUES(value), max = VALUES(max)");
 
     // we don't need transactions here.
     for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end();)
@@ -15681,51 +15726,31 @@ void Player::_SaveSkills()
             continue;
         }
 
+        // new or changed
         uint32 valueData = GetUInt32Value(PLAYER_SKILL_VALUE_INDEX(itr->second.pos));
-        uint16 value = SKILL_VALUE(valueData);
-        uint16 max = SKILL_MAX(valueData);
-
-        switch (itr->second.uState)
-        {
-            case SKILL_NEW:
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(insSkills, "INSERT INTO character_skills (guid, skill, value, max) VALUES (?, ?, ?, ?)");
-                stmt.PExecute(GetGUIDLow(), itr->first, value, max);
-            }
-            break;
-            case SKILL_CHANGED:
-            {
-                SqlStatement stmt = CharacterDatabase.CreateStatement(updSkills, "UPDATE character_skills SET value = ?, max = ? WHERE guid = ? AND skill = ?");
-                stmt.PExecute(value, max, GetGUIDLow(), itr->first);
-            }
-            break;
-            case SKILL_UNCHANGED:
-            case SKILL_DELETED:
-                MANGOS_ASSERT(false);
-                break;
-        };
+        batch.NewRow() << GetGUIDLow() << ", " << itr->first << ", " << SKILL_VALUE(valueData) << ", " << SKILL_MAX(valueData);
         itr->second.uState = SKILL_UNCHANGED;
 
         ++itr;
     }
+    batch.Flush();
 }
 
 void Player::_SaveSpells()
 {
     static SqlStatementID delSpells ;
-    static SqlStatementID insSpells ;
 
     SqlStatement stmtDel = CharacterDatabase.CreateStatement(delSpells, "DELETE FROM character_spell WHERE guid = ? and spell = ?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insSpells, "INSERT INTO character_spell (guid,spell,active,disabled) VALUES (?, ?, ?, ?)");
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_spell (guid,spell,active,disabled)",
+        "ON DUPLICATE KEY UPDATE active = VALUES(active), disabled = VALUES(disabled)");
 
-    for (PlayerSpellMap::iterator itr = m_spells.begin(), next = m_spells.begin(); itr != m_spells.end();)
+    for (PlayerSpellMap::iterator itr = m_spells.begin(); itr != m_spells.end();)
     {
-        if (itr->second.state == PLAYERSPELL_REMOVED || itr->second.state == PLAYERSPELL_CHANGED)
-            stmtDel.PExecute(GetGUIDLow(), itr->first);
-
         // add only changed/new not dependent spells
         if (!itr->second.dependent && (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED))
-            stmtIns.PExecute(GetGUIDLow(), itr->first, uint8(itr->second.active ? 1 : 0), uint8(itr->second.disabled ? 1 : 0));
+            batch.NewRow() << GetGUIDLow() << ", " << itr->first << ", " << uint32(itr->second.active ? 1 : 0) << ", " << uint32(itr->second.disabled ? 1 : 0);
+        else if (itr->second.state == PLAYERSPELL_REMOVED || itr->second.state == PLAYERSPELL_CHANGED)
+            stmtDel.PExecute(GetGUIDLow(), itr->first);
 
         if (itr->second.state == PLAYERSPELL_REMOVED)
             m_spells.erase(itr++);
@@ -15736,6 +15761,7 @@ void Player::_SaveSpells()
         }
 
     }
+    batch.Flush();
 }
 
 // save player stats -- only for external usage
@@ -15746,35 +15772,29 @@ void Player::_SaveStats()
     if (!sWorld.getConfig(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE) || getLevel() < sWorld.getConfig(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE))
         return;
 
-    static SqlStatementID delStats ;
-    static SqlStatementID insertStats ;
-
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delStats, "DELETE FROM character_stats WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    stmt = CharacterDatabase.CreateStatement(insertStats, "INSERT INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
-            "strength, agility, stamina, intellect, spirit, armor, resHoly, resFire, resNature, resFrost, resShadow, resArcane, "
-            "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower) "
-            "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-
-    stmt.addUInt32(GetGUIDLow());
-    stmt.addUInt32(GetMaxHealth());
+    std::ostringstream row;
+    row << GetGUIDLow() << ", " << GetMaxHealth();
     for (int i = 0; i < MAX_POWERS; ++i)
-        stmt.addUInt32(GetMaxPower(Powers(i)));
+        row << ", " << GetMaxPower(Powers(i));
     for (int i = 0; i < MAX_STATS; ++i)
-        stmt.addFloat(GetStat(Stats(i)));
+        row << ", " << finiteAlways(GetStat(Stats(i)));
     // armor + school resistances
     for (int i = 0; i < MAX_SPELL_SCHOOL; ++i)
-        stmt.addUInt32(GetResistance(SpellSchools(i)));
-    stmt.addFloat(GetFloatValue(PLAYER_BLOCK_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_DODGE_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_PARRY_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_CRIT_PERCENTAGE));
-    stmt.addFloat(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_ATTACK_POWER));
-    stmt.addUInt32(GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER));
+        row << ", " << GetResistance(SpellSchools(i));
+    row << ", " << finiteAlways(GetFloatValue(PLAYER_BLOCK_PERCENTAGE)) << ", " << finiteAlways(GetFloatValue(PLAYER_DODGE_PERCENTAGE))
+        << ", " << finiteAlways(GetFloatValue(PLAYER_PARRY_PERCENTAGE)) << ", " << finiteAlways(GetFloatValue(PLAYER_CRIT_PERCENTAGE))
+        << ", " << finiteAlways(GetFloatValue(PLAYER_RANGED_CRIT_PERCENTAGE)) << ", " << GetUInt32Value(UNIT_FIELD_ATTACK_POWER)
+        << ", " << GetUInt32Value(UNIT_FIELD_RANGED_ATTACK_POWER);
+
+    // unchanged since the last save
+    if (row.str() == m_savedStats)
+        return;
+    m_savedStats = row.str();
 
-    stmt.Execute();
+    CharacterDatabase.PExecute("REPLACE INTO character_stats (guid, maxhealth, maxpower1, maxpower2, maxpower3, maxpower4, maxpower5, "
+        "strength, agility, stamina, intellect, spirit, armor, resHoly, resFire, resNature, resFrost, resShadow, resArcane, "
+        "blockPct, dodgePct, parryPct, critPct, rangedCritPct, attackPower, rangedAttackPower) "
+        "VALUES (%s)", m_savedStats.c_str());
 }
 
 void Player::outDebugStatsValues() const
@@ -19756,9 +19776,10 @@ void Player::InterruptSpellsWithCastItem(Item* item)
             }
 
     // Interrupt eventually delayed spells
-    EventList::iterator it = m_Events.m_events.begin();
-    for (; it != m_Events.m_events.end(); ++it)
-        if (SpellEvent* event = dynamic_cast<SpellEvent*>(it->second))
+    std::vector<BasicEvent*> events;
+    m_Events.GetEvents(events);
+    for (std::vector<BasicEvent*>::const_iterator it = events.begin(); it != events.end(); ++it)
+        if (SpellEvent* event = dynamic_cast<SpellEvent*>(*it))
             if (event && event->GetSpell()->m_CastItem == item)
             {
                 event->GetSpell()->ClearCastItem();
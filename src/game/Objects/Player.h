@@ -44,6 +44,7 @@
 
 #include <string>
 #include <vector>
+#include <tuple>
 
 struct Mail;
 class Channel;
@@ -823,6 +824,8 @@ struct AuraSaveStruct
     int32 maxduration;
     int32 remaintime;
     uint32 effIndexMask;
+
+    bool operator==(AuraSaveStruct const& other) const;
 };
 
 class MANGOS_DLL_SPEC Player final: public Unit
@@ -2109,7 +2112,7 @@ class MANGOS_DLL_SPEC Player final: public Unit
             m_DelayedOperations &= ~operation;
         }
 
-        inline bool HasScheduledEvent() const { return m_Events.m_events.size(); }
+        inline bool HasScheduledEvent() const { return m_Events.HasEvents(); }
         void SetAutoInstanceSwitch(bool v) { m_enableInstanceSwitch = v; }
     protected:
         bool   m_enableInstanceSwitch;
@@ -2199,6 +2202,15 @@ class MANGOS_DLL_SPEC Player final: public Unit
         void _SaveBGData();
         void _SaveStats();
 
+        // Rows written by the previous save, so that the next ones only write what changed.
+        // Not known until the first save, which rewrites everything.
+        typedef std::tuple<uint64, uint32, uint32> SavedAuraKey;                 // caster guid, item guid, spell
+        typedef std::map<SavedAuraKey, AuraSaveStruct> SavedAuraMap;
+        SavedAuraMap m_savedAuras;
+        SpellCooldowns m_savedSpellCooldowns;
+        std::string m_savedStats;
+        bool m_savedRowsKnown;
+
         void _SetCreateBits(UpdateMask *updateMask, Player *target) const;
         void _SetUpdateBits(UpdateMask *updateMask, Player *target) const;
 
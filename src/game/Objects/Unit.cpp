@@ -135,6 +135,7 @@ Unit::Unit()
     //m_AurasCheck = 2000;
     //m_removeAuraTimer = 4;
     m_spellAuraHoldersUpdateIterator = m_spellAuraHolders.end();
+    m_procAuraHoldersGeneration = sSpellMgr.GetSpellProcEventsGeneration();
     m_AuraFlags = 0;
 
     m_Visibility = VISIBILITY_ON;
@@ -3947,6 +3948,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder *holder)
     }
     // add aura, register in lists and arrays
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    AddProcAuraHolder(holder);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura *aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -4532,6 +4534,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder *holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            RemoveProcAuraHolder(holder);
             foundInMap = true;
             break;
         }
@@ -9163,22 +9166,35 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
     }
     DEBUG_UNIT(this, DEBUG_PROCS, "PROC: Flags 0x%.5x Ex 0x%.3x Spell %5u %s", procFlag, procExtra, procSpell ? procSpell->Id : 0, isVictim ? "[victim]" : "");
 
-    // Fill triggeredList list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+    FillProcTriggeredList(isVictim, pTarget, procFlag, procExtra, attType, procSpell, triggeredList, spell);
+}
+
+void Unit::FillProcTriggeredList(bool isVictim, Unit* pTarget, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, SpellEntry const* procSpell, ProcTriggeredList& triggeredList, Spell* spell)
+{
+    if (m_procAuraHoldersGeneration != sSpellMgr.GetSpellProcEventsGeneration())
+        RebuildProcAuraHolders();
+
+    for (size_t i = 0; i < m_procAuraHolders.size(); ++i)
     {
+        // Most holders can not proc on this event: skip them before any lookup
+        if (!(m_procAuraHolders[i].procMask & procFlag))
+            continue;
+
+        SpellAuraHolder* holder = m_procAuraHolders[i].holder;
+
         // Can not proc on self.
-        if (procSpell && procSpell->Id == itr->first)
+        if (procSpell && procSpell->Id == holder->GetId())
             continue;
 
         // skip deleted auras (possible at recursive triggered call
-        if (itr->second->IsDeleted())
+        if (holder->IsDeleted())
             continue;
 
         // Aura that applies a modifier with charges. Gere? otherwise.
         bool hasmodifier = false;
-        for (int i = 0; i < 3; ++i)
-            if (itr->second->GetAuraByEffectIndex(SpellEffectIndex(i)))
-                if (SpellModifier* auraMod = itr->second->GetAuraByEffectIndex(SpellEffectIndex(i))->GetSpellModifier())
+        for (int j = 0; j < 3; ++j)
+            if (holder->GetAuraByEffectIndex(SpellEffectIndex(j)))
+                if (SpellModifier* auraMod = holder->GetAuraByEffectIndex(SpellEffectIndex(j))->GetSpellModifier())
                     if (auraMod->charges > 0 || (spell && spell->HasModifierApplied(auraMod)))
                     {
                         hasmodifier = true;
@@ -9188,14 +9204,48 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
             continue;
 
         SpellProcEventEntry const* spellProcEvent = nullptr;
-        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
+        if (!IsTriggeredAtSpellProcEvent(pTarget, holder, procSpell, procFlag, procExtra, attType, isVictim, spellProcEvent))
             continue;
 
-        itr->second->SetInUse(true);                        // prevent holder deletion
-        triggeredList.push_back(ProcTriggeredData(spellProcEvent, itr->second, pTarget, procFlag));
+        holder->SetInUse(true);                             // prevent holder deletion
+        triggeredList.push_back(ProcTriggeredData(spellProcEvent, holder, pTarget, procFlag));
     }
 }
 
+void Unit::AddProcAuraHolder(SpellAuraHolder* holder)
+{
+    uint32 procMask = GetSpellProcMask(holder->GetSpellProto());
+    if (!procMask)
+        return;
+
+    // Same order as m_spellAuraHolders: by spell id, then insertion order
+    ProcAuraHolderList::iterator itr = m_procAuraHolders.begin();
+    while (itr != m_procAuraHolders.end() && itr->holder->GetId() <= holder->GetId())
+        ++itr;
+    m_procAuraHolders.insert(itr, ProcAuraHolderEntry(holder, procMask));
+}
+
+void Unit::RemoveProcAuraHolder(SpellAuraHolder* holder)
+{
+    for (ProcAuraHolderList::iterator itr = m_procAuraHolders.begin(); itr != m_procAuraHolders.end(); ++itr)
+    {
+        if (itr->holder == holder)
+        {
+            m_procAuraHolders.erase(itr);
+            return;
+        }
+    }
+}
+
+void Unit::RebuildProcAuraHolders()
+{
+    m_procAuraHolders.clear();
+    for (SpellAuraHolderMap::const_iterator itr = m_spellAuraHolders.begin(); itr != m_spellAuraHolders.end(); ++itr)
+        if (uint32 procMask = GetSpellProcMask(itr->second->GetSpellProto()))
+            m_procAuraHolders.push_back(ProcAuraHolderEntry(itr->second, procMask));
+    m_procAuraHoldersGeneration = sSpellMgr.GetSpellProcEventsGeneration();
+}
+
 SpellSchoolMask Unit::GetMeleeDamageSchoolMask() const
 {
     return SPELL_SCHOOL_MASK_NORMAL;
@@ -9521,6 +9571,7 @@ void Unit::UpdateModelData()
         SetFloatValue(UNIT_FIELD_COMBATREACH, 1.5f);
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, 1.5f);
     }
+    RefreshPositionCache();
 }
 
 void Unit::ClearComboPointHolders()
@@ -9597,7 +9648,7 @@ Unit* Unit::SelectRandomUnfriendlyTarget(Unit* except /*= NULL*/, float radius /
 
     MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, radius);
     MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, radius);
+    Cell::VisitUnitsInRange(this, searcher, radius, true);
 
     // remove current target
     if (except)
@@ -10190,7 +10241,7 @@ void Unit::ProcessRelocationVisibilityUpdates()
     if (!IsInWorld())
         return;
 
-    GetViewPoint().Call_UpdateVisibilityForOwner(); // HEAVY LOAD
+    GetViewPoint().Call_UpdateVisibilityForOwnerAfterMove(); // HEAVY LOAD
     UpdateObjectVisibility();
 }
 
@@ -10214,9 +10265,10 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed, bool interruptPositiveSpe
         if (!killDelayed)
             continue;
         // 2/ Interruption des sorts qui ne sont plus reference, mais dont il reste un event (ceux en parcours par exemple)
-        EventList::iterator it = (*iter)->m_Events.m_events.begin();
-        for (; it != (*iter)->m_Events.m_events.end(); ++it)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(it->second))
+        std::vector<BasicEvent*> events;
+        (*iter)->m_Events.GetEvents(events);
+        for (std::vector<BasicEvent*>::const_iterator it = events.begin(); it != events.end(); ++it)
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(*it))
                 if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
@@ -10230,7 +10282,7 @@ void Unit::InterruptAttacksOnMe(float dist)
     std::list<Unit*> targets;
     MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, dist);
     MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, dist);
+    Cell::VisitUnitsInRange(this, searcher, dist, true);
     for (std::list<Unit*>::iterator iter = targets.begin(); iter != targets.end(); ++iter)
     {
         if ((*iter)->getVictim() != this)
@@ -10248,7 +10300,7 @@ void Unit::CombatStopInRange(float dist)
     std::list<Unit*> targets;
     MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, dist);
     MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, dist);
+    Cell::VisitUnitsInRange(this, searcher, dist, true);
     for (std::list<Unit*>::iterator iter = targets.begin(); iter != targets.end(); ++iter)
         (*iter)->CombatStopWithPets(true);
 }
@@ -10296,7 +10348,7 @@ uint32 Unit::DespawnHostileCreaturesInRange(float range)
     std::list<Unit*> targets;
     MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck u_check(this, this, range);
     MaNGOS::UnitListSearcher<MaNGOS::AnyUnfriendlyUnitInObjectRangeCheck> searcher(targets, u_check);
-    Cell::VisitAllObjects(this, searcher, range);
+    Cell::VisitUnitsInRange(this, searcher, range, true);
     for (std::list<Unit*>::iterator iter = targets.begin(); iter != targets.end(); ++iter)
     {
         if ((*iter)->GetTypeId() == TYPEID_UNIT)
@@ -934,6 +934,16 @@ struct ProcTriggeredData
 
 typedef std::list< ProcTriggeredData > ProcTriggeredList;
 
+// Aura holder which may proc, and the PROC_FLAG_* it may proc on
+struct ProcAuraHolderEntry
+{
+    ProcAuraHolderEntry(SpellAuraHolder* _holder, uint32 _procMask) : holder(_holder), procMask(_procMask) {}
+    SpellAuraHolder* holder;
+    uint32 procMask;                                        // all bits for auras with hardcoded proc conditions
+};
+
+typedef std::vector< ProcAuraHolderEntry > ProcAuraHolderList;
+
 enum TeleportToOptions
 {
     TELE_TO_GM_MODE             = 0x01,
@@ -1183,6 +1193,8 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
 
         void ProcDamageAndSpell(Unit *pVictim, uint32 procAttacker, uint32 procVictim, uint32 procEx, uint32 amount, WeaponAttackType attType = BASE_ATTACK, SpellEntry const *procSpell = nullptr, Spell* spell = nullptr);
         void ProcDamageAndSpellFor(bool isVictim, Unit * pTarget, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, SpellEntry const* procSpell, uint32 damage, ProcTriggeredList& triggeredList, Spell* spell = nullptr);
+        // Fills triggeredList with the auras proccing on this event. Only looks at m_procAuraHolders.
+        void FillProcTriggeredList(bool isVictim, Unit * pTarget, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, SpellEntry const* procSpell, ProcTriggeredList& triggeredList, Spell* spell = nullptr);
         void HandleTriggers(Unit *pVictim, uint32 procExtra, uint32 amount, SpellEntry const *procSpell, ProcTriggeredList const& procTriggered);
 
         void HandleEmote(uint32 emote_id);                  // auto-select command/state
@@ -1606,6 +1618,7 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
 
         SpellAuraHolderMap      & GetSpellAuraHolderMap()       { return m_spellAuraHolders; }
         SpellAuraHolderMap const& GetSpellAuraHolderMap() const { return m_spellAuraHolders; }
+        ProcAuraHolderList const& GetProcAuraHolders() const { return m_procAuraHolders; }
         AuraList const& GetAurasByType(AuraType type) const { return m_modAuras[type]; }
         void ApplyAuraProcTriggerDamage(Aura* aura, bool apply);
 
@@ -1678,6 +1691,8 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         uint32 SpellCriticalHealingBonus(SpellEntry const *spellProto, uint32 damage, Unit *pVictim);
 
         bool IsTriggeredAtSpellProcEvent(Unit *pVictim, SpellAuraHolder* holder, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, SpellProcEventEntry const*& spellProcEvent );
+        // PROC_FLAG_* on which IsTriggeredAtSpellProcEvent may accept an aura of this spell (0 = never)
+        static uint32 GetSpellProcMask(SpellEntry const* spellProto);
         // Aura proc handlers
         SpellAuraProcResult HandleDummyAuraProc(Unit *pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
         SpellAuraProcResult HandleHasteAuraProc(Unit *pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const *procSpell, uint32 procFlag, uint32 procEx, uint32 cooldown);
@@ -1920,6 +1935,12 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
         AuraList m_deletedAuras;                                       // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
+        // Holders of m_spellAuraHolders which may proc, in the same order
+        ProcAuraHolderList m_procAuraHolders;
+        uint32 m_procAuraHoldersGeneration;                 // SpellMgr::GetSpellProcEventsGeneration() at last build
+        void AddProcAuraHolder(SpellAuraHolder* holder);
+        void RemoveProcAuraHolder(SpellAuraHolder* holder);
+        void RebuildProcAuraHolders();
 
         SingleCastSpellTargetMap m_singleCastSpellTargets;  // casted by unit single per-caster auras
 
@@ -26,6 +26,8 @@
 #include "World.h"
 #include "ObjectGuid.h"
 #include <zlib/zlib.h>
+#include <atomic>
+#include <chrono>
 
 #define MAX_UNCOMPRESSED_PACKET_SIZE 0x8000 // 32ko
 
@@ -54,7 +56,7 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
         m_datas.push_back(UpdatePacket());
     std::list<UpdatePacket>::iterator it = m_datas.end();
     --it;
-    if (it->data.wpos() > MAX_UNCOMPRESSED_PACKET_SIZE)
+    if (it->Size() > MAX_UNCOMPRESSED_PACKET_SIZE)
     {
         m_datas.push_back(UpdatePacket());
         it = m_datas.end();
@@ -64,29 +66,147 @@ void UpdateData::AddUpdateBlock(const ByteBuffer &block)
     ++it->blockCount;
 }
 
-void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+void UpdateData::AddUpdateBlock(SharedUpdateBlockPtr const& block, std::vector<uint32>&& viewerValues)
+{
+    MANGOS_ASSERT(viewerValues.size() == block->viewerFields.size());
+    if (!m_datas.size())
+        m_datas.push_back(UpdatePacket());
+    std::list<UpdatePacket>::iterator it = m_datas.end();
+    --it;
+    if (it->Size() > MAX_UNCOMPRESSED_PACKET_SIZE)
+    {
+        m_datas.push_back(UpdatePacket());
+        it = m_datas.end();
+        --it;
+    }
+    it->sharedBlocks.emplace_back(block, std::move(viewerValues), it->data.wpos());
+    it->sharedSize += block->data.wpos();
+    ++it->blockCount;
+}
+
+void UpdateData::Merge(UpdateData& other)
 {
-    z_stream c_stream;
+    m_outOfRangeGUIDs.insert(other.m_outOfRangeGUIDs.begin(), other.m_outOfRangeGUIDs.end());
+    other.m_outOfRangeGUIDs.clear();
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+    for (std::list<UpdatePacket>::iterator it = other.m_datas.begin(); it != other.m_datas.end(); ++it)
+    {
+        if (!m_datas.empty() && m_datas.back().Size() + it->Size() <= MAX_UNCOMPRESSED_PACKET_SIZE)
+            m_datas.back().Append(*it);
+        else
+            m_datas.push_back(std::move(*it));
+    }
+    other.m_datas.clear();
+}
+
+void UpdatePacket::Append(UpdatePacket& other)
+{
+    size_t offset = data.wpos();
+    for (std::vector<SharedBlockRef>::iterator it = other.sharedBlocks.begin(); it != other.sharedBlocks.end(); ++it)
+    {
+        it->position += offset;
+        sharedBlocks.push_back(std::move(*it));
+    }
+    if (other.data.wpos())
+        data.append(other.data.contents(), other.data.wpos());
+    blockCount += other.blockCount;
+    sharedSize += other.sharedSize;
+
+    other.sharedBlocks.clear();
+    other.data.clear();
+    other.blockCount = 0;
+    other.sharedSize = 0;
+}
+
+void UpdatePacket::WriteTo(ByteBuffer& buf) const
+{
+    size_t copied = 0;
+    for (std::vector<SharedBlockRef>::const_iterator it = sharedBlocks.begin(); it != sharedBlocks.end(); ++it)
+    {
+        if (it->position > copied)
+            buf.append(data.contents() + copied, it->position - copied);
+        copied = it->position;
+
+        ByteBuffer const& shared = it->block->data;
+        size_t blockStart = buf.wpos();
+        buf.append(shared.contents(), shared.wpos());
+        for (size_t i = 0; i < it->viewerValues.size(); ++i)
+            buf.put<uint32>(blockStart + it->block->viewerFields[i].offset, it->viewerValues[i]);
+    }
+    if (data.wpos() > copied)
+        buf.append(data.contents() + copied, data.wpos() - copied);
+}
+
+namespace
+{
+    std::atomic<uint64> s_compressedPackets(0);
+    std::atomic<uint64> s_compressedBytesIn(0);
+    std::atomic<uint64> s_compressedBytesOut(0);
+    std::atomic<uint64> s_compressionTimeUs(0);
+
+    struct DeflateContext
+    {
+        DeflateContext() : level(-1)
+        {
+            stream.zalloc = (alloc_func)0;
+            stream.zfree = (free_func)0;
+            stream.opaque = (voidpf)0;
+        }
+        ~DeflateContext()
+        {
+            if (level >= 0)
+                deflateEnd(&stream);
+        }
+
+        // Returns a stream ready for a new packet
+        z_stream* Get(int wantedLevel)
+        {
+            if (level == wantedLevel)
+            {
+                int z_res = deflateReset(&stream);
+                if (z_res == Z_OK)
+                    return &stream;
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            }
+            if (level >= 0)
+                deflateEnd(&stream);
+            level = -1;
+
+            int z_res = deflateInit(&stream, wantedLevel);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return nullptr;
+            }
+            level = wantedLevel;
+            return &stream;
+        }
+
+        z_stream stream;
+        int level;                                          // -1 if not initialized
+    };
+
+    thread_local DeflateContext t_deflateContext;
+}
+
+void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = t_deflateContext.Get(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -94,14 +214,14 @@ void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
@@ -109,15 +229,54 @@ void PacketCompressor::Compress(void* dst, uint32 *dst_size, void* src, int src_
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    *dst_size = c_stream->total_out;
+
+    ++s_compressedPackets;
+    s_compressedBytesIn += src_size;
+    s_compressedBytesOut += *dst_size;
+    s_compressionTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool PacketCompressor::CompressPacket(WorldPacket& packet, uint16 compressedOpcode, ByteBuffer const& src)
+{
+    MANGOS_ASSERT(packet.empty());
+
+    size_t pSize = src.wpos();                              // use real used data size
+    if (pSize >= 900000)
+        sLog.outInfo("[CRASH-CLIENT] Too large packet: %u (opcode %u)", pSize, compressedOpcode);
+
+    uint32 destsize = compressBound(pSize);
+    packet.resize(destsize + sizeof(uint32));
+    packet.put<uint32>(0, pSize);
+    Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), &destsize, (void*)src.contents(), pSize);
+    packet.SetCompressionPending(false);
+    if (destsize == 0)
+        return false;
+
+    packet.resize(destsize + sizeof(uint32));
+    packet.SetOpcode(compressedOpcode);
+    return true;
+}
+
+bool PacketCompressor::CompressPendingPacket(WorldPacket& packet)
+{
+    if (!packet.IsCompressionPending())
+        return true;
 
-    *dst_size = c_stream.total_out;
+    // Opcode is already the compressed one
+    ByteBuffer uncompressed(std::move(packet));
+    packet.clear();
+    return CompressPacket(packet, packet.GetOpcode(), uncompressed);
+}
+
+PacketCompressor::Stats PacketCompressor::GetStats()
+{
+    Stats stats;
+    stats.packets = s_compressedPackets;
+    stats.bytesIn = s_compressedBytesIn;
+    stats.bytesOut = s_compressedBytesOut;
+    stats.timeUs = s_compressionTimeUs;
+    return stats;
 }
 
 bool UpdateData::BuildPacket(WorldPacket *packet, bool hasTransport)
@@ -131,7 +290,7 @@ bool UpdateData::BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket,
 {
     MANGOS_ASSERT(packet->empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + (updPacket ? updPacket->data.wpos() : 0));
+    ByteBuffer buf(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + (updPacket ? updPacket->Size() : 0));
 
     uint32 blockCount = updPacket ? updPacket->blockCount : 0;
     buf << (uint32)(!m_outOfRangeGUIDs.empty() ? blockCount + 1 : blockCount);
@@ -147,36 +306,31 @@ bool UpdateData::BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket,
     }
 
     if (updPacket)
-        buf.append(updPacket->data);
+        updPacket->WriteTo(buf);
 
     size_t pSize = buf.wpos();                              // use real used data size
 
     if (pSize > 100)                                       // compress large packets
     {
-        if (pSize >= 900000)
-            sLog.outInfo("[CRASH-CLIENT] Too large packet: %u", pSize);
-
-        uint32 destsize = compressBound(pSize);
-        packet->resize(destsize + sizeof(uint32));
+        if (!sWorld.getConfig(CONFIG_BOOL_COMPRESSION_DEFERRED))
+            return PacketCompressor::CompressPacket(*packet, SMSG_COMPRESSED_UPDATE_OBJECT, buf);
 
-        packet->put<uint32>(0, pSize);
-        PacketCompressor::Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
-        if (destsize == 0)
-            return false;
-
-        packet->resize(destsize + sizeof(uint32));
+        // Compressed by the network thread, see WorldSocket::PrepareQueuedPacket
+        packet->append(buf);
         packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+        packet->SetCompressionPending(true);
     }
     else                                                    // send small packets without compression
     {
         packet->append(buf);
         packet->SetOpcode(SMSG_UPDATE_OBJECT);
+        packet->SetCompressionPending(false);
     }
 
     return true;
 }
 
-void UpdateData::Send(WorldSession* session, bool hasTransport)
+uint32 UpdateData::Send(WorldSession* session, bool hasTransport)
 {
     WorldPacket data;
     if (!m_datas.size() && !m_outOfRangeGUIDs.empty())
@@ -184,7 +338,7 @@ void UpdateData::Send(WorldSession* session, bool hasTransport)
         BuildPacket(&data, NULL, hasTransport);
         session->SendPacket(&data);
         m_outOfRangeGUIDs.clear();
-        return;
+        return 1;
     }
     for (std::list<UpdatePacket>::iterator it = m_datas.begin(); it != m_datas.end(); ++it)
     {
@@ -193,6 +347,7 @@ void UpdateData::Send(WorldSession* session, bool hasTransport)
         data.clear();
         m_outOfRangeGUIDs.clear();
     }
+    return m_datas.size();
 }
 
 void UpdateData::Clear()
@@ -233,19 +388,5 @@ bool MovementData::BuildPacket(WorldPacket& packet)
 {
     MANGOS_ASSERT(packet.empty()); // We want a clean packet !
 
-    size_t pSize = _buffer.wpos();                              // use real used data size
-
-    if (pSize >= 900000)
-        sLog.outInfo("[CRASH-CLIENT] Too large packet size %u (SMSG_COMPRESSED_MOVES)", pSize);
-
-    uint32 destsize = compressBound(pSize);
-    packet.resize(destsize + sizeof(uint32));
-    packet.put<uint32>(0, pSize);
-    PacketCompressor::Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), &destsize, (void*)_buffer.contents(), pSize);
-    if (destsize == 0)
-        return false;
-
-    packet.resize(destsize + sizeof(uint32));
-    packet.SetOpcode(SMSG_COMPRESSED_MOVES);
-    return true;
+    return PacketCompressor::CompressPacket(packet, SMSG_COMPRESSED_MOVES, _buffer);
 }
@@ -22,6 +22,8 @@
 
 #include "ByteBuffer.h"
 #include "ObjectGuid.h"
+#include <memory>
+#include <vector>
 
 class WorldPacket;
 class WorldSession;
@@ -50,18 +52,74 @@ enum ObjectUpdateFlags
     UPDATEFLAG_HAS_POSITION = 0x0040
 };
 
+/**
+ * Values update block of an object, built once per tick and shared by every player seeing it.
+ * Fields whose value depends on the viewer are written as placeholders, their position
+ * is kept in 'viewerFields' and the real values are patched in UpdateData::BuildPacket.
+ */
+class SharedUpdateBlock
+{
+    public:
+        struct ViewerField
+        {
+            ViewerField(uint32 pos, uint16 idx) : offset(pos), index(idx) {}
+            uint32 offset;                                  // in 'data'
+            uint16 index;                                   // update field
+        };
+
+        SharedUpdateBlock() : data(500) {}
+        ByteBuffer data;
+        std::vector<ViewerField> viewerFields;
+};
+
+typedef std::shared_ptr<SharedUpdateBlock const> SharedUpdateBlockPtr;
+
 class UpdatePacket
 {
     public:
-        UpdatePacket() : blockCount(0) {}
+        // A shared block inserted at 'position' in 'data', with the values of its viewer fields
+        struct SharedBlockRef
+        {
+            SharedBlockRef(SharedUpdateBlockPtr const& b, std::vector<uint32>&& v, size_t pos) : block(b), viewerValues(std::move(v)), position(pos) {}
+            SharedUpdateBlockPtr block;
+            std::vector<uint32> viewerValues;
+            size_t position;
+        };
+
+        UpdatePacket() : blockCount(0), sharedSize(0) {}
+        size_t Size() const { return data.wpos() + sharedSize; }
+        void WriteTo(ByteBuffer& buf) const;
+        void Append(UpdatePacket& other);
+
         ByteBuffer data;
         uint32 blockCount;
+        std::vector<SharedBlockRef> sharedBlocks;
+        size_t sharedSize;
 };
 
+/**
+ * zlib compression of SMSG_COMPRESSED_UPDATE_OBJECT / SMSG_COMPRESSED_MOVES.
+ * Each thread keeps its own deflate stream, reset between packets instead of being
+ * allocated and initialized again every time.
+ */
 class PacketCompressor
 {
     public:
+        struct Stats
+        {
+            uint64 packets;
+            uint64 bytesIn;
+            uint64 bytesOut;
+            uint64 timeUs;
+        };
+
         static void Compress(void* dst, uint32 *dst_size, void* src, int src_size);
+        // Writes the uncompressed size and the compressed content of 'src' in the empty 'packet'
+        static bool CompressPacket(WorldPacket& packet, uint16 compressedOpcode, ByteBuffer const& src);
+        // Same, for a packet built with compression deferred to the network thread
+        static bool CompressPendingPacket(WorldPacket& packet);
+
+        static Stats GetStats();
 };
 
 class UpdateData
@@ -73,7 +131,11 @@ class UpdateData
         void AddOutOfRangeGUID(ObjectGuidSet& guids);
         void AddOutOfRangeGUID(ObjectGuid const &guid);
         void AddUpdateBlock(const ByteBuffer &block);
-        void Send(WorldSession* session, bool hasTransport = false);
+        void AddUpdateBlock(SharedUpdateBlockPtr const& block, std::vector<uint32>&& viewerValues);
+        // Moves the content of 'other' at the end of this one, packing small packets together
+        void Merge(UpdateData& other);
+        // Returns the number of packets sent
+        uint32 Send(WorldSession* session, bool hasTransport = false);
         bool BuildPacket(WorldPacket *packet, bool hasTransport = false);
         bool BuildPacket(WorldPacket *packet, UpdatePacket const* updPacket, bool hasTransport = false);
         bool HasData() { return m_datas.size() || !m_outOfRangeGUIDs.empty(); }
@@ -7,12 +7,12 @@ uint32 PlayerBroadcaster::num_bcaster_created = 0;
 uint32 PlayerBroadcaster::num_bcaster_deleted = 0;
 
 PlayerBroadcaster::PlayerBroadcaster(WorldSocket* w_socket, const ObjectGuid& self, std::size_t max_queue)
-    : m_socket(w_socket), m_self(self), MAX_QUEUE_SIZE(max_queue), instanceId(0), lastUpdatePackets(0)
+    : MAX_QUEUE_SIZE(max_queue), m_socket(w_socket), m_self(self), m_queue(max_queue), m_overflow_size(0),
+      m_clear_listeners(false), m_listeners_changed(false), instanceId(0), lastUpdatePackets(0)
 {
     if (m_socket)
         m_socket->AddReference();
 
-    m_queue.reserve(max_queue);
     ++num_bcaster_created;
 }
 
@@ -32,81 +32,129 @@ void PlayerBroadcaster::AddListener(Player const* player)
         return;
 
     std::lock_guard<std::mutex> guard(m_listeners_lock);
-    m_listeners[player->GetObjectGuid()] = player->m_broadcaster;
+    m_listener_changes[player->GetObjectGuid()] = player->m_broadcaster;
+    m_listeners_changed = true;
 }
 
 void PlayerBroadcaster::RemoveListener(Player const* player)
 {
     ASSERT(player);
     std::lock_guard<std::mutex> guard(m_listeners_lock);
-    m_listeners.erase(player->GetObjectGuid());
+    m_listener_changes[player->GetObjectGuid()].reset();
+    m_listeners_changed = true;
 }
 
 void PlayerBroadcaster::ClearListeners()
 {
     std::lock_guard<std::mutex> guard(m_listeners_lock);
-    m_listeners.clear();
+    m_listener_changes.clear();
+    m_clear_listeners = true;
+    m_listeners_changed = true;
+}
+
+void PlayerBroadcaster::ApplyListenerChanges()
+{
+    if (!m_listeners_changed)
+        return;
+
+    ListenersMap changes;
+    bool clear;
+    {
+        std::lock_guard<std::mutex> guard(m_listeners_lock);
+        changes.swap(m_listener_changes);
+        clear = m_clear_listeners;
+        m_clear_listeners = false;
+        m_listeners_changed = false;
+    }
+
+    if (clear)
+        m_listeners.clear();
+    for (auto& change : changes)
+    {
+        if (change.second)
+            m_listeners[change.first] = std::move(change.second);
+        else
+            m_listeners.erase(change.first);
+    }
 }
 
-void PlayerBroadcaster::SendPacket(const WorldPacket& packet)
+void PlayerBroadcaster::SendPacket(std::shared_ptr<WorldPacket const> const& packet)
 {
     if (m_socket)
         m_socket->SendPacket(packet);
 }
 
+void PlayerBroadcaster::Broadcast(BroadcastData const& data)
+{
+    // Send to self?
+    if (data.sendToSelf && data.except != GetGUID())
+        SendPacket(data.packet);
+
+    for (auto it = m_listeners.begin(); it != m_listeners.end(); ++it)
+    {
+        if (it->first == data.except)
+            continue;
+
+        it->second->SendPacket(data.packet);
+    }
+}
+
 void PlayerBroadcaster::ProcessQueue(uint32& num_packets)
 {
-    if (m_queue.empty())
+    std::lock_guard<std::mutex> guard(m_process_lock);
+    if (m_queue.empty() && !m_overflow_size && !m_listeners_changed)
         return;
 
-    std::unique_lock<std::mutex> q_g(m_queue_lock), v_g(m_listeners_lock);
-    auto queue = std::move(m_queue);
-    q_g.unlock();
+    ApplyListenerChanges();
 
-    lastUpdatePackets = queue.size() * m_listeners.size();
-    num_packets += lastUpdatePackets;
+    // Do not chase producers forever: at most one ring of packets, then the overflow
+    uint32 count = 0;
+    BroadcastData data;
+    for (std::size_t i = m_queue.capacity(); i && m_queue.pop(data); --i, ++count)
+        Broadcast(data);
 
-    for (auto& data : queue)
+    if (m_overflow_size)
     {
-        // Send to self?
-        if (data.sendToSelf && data.except != GetGUID())
-            SendPacket(data.packet);
-
-        for (auto it = m_listeners.begin(); it != m_listeners.end(); ++it)
+        std::vector<BroadcastData> overflow;
         {
-            if (it->first == data.except)
-                continue;
-
-            it->second->SendPacket(data.packet);
+            std::lock_guard<std::mutex> o_g(m_overflow_lock);
+            overflow.swap(m_overflow);
+            m_overflow_size = 0;
         }
+        for (auto const& queued : overflow)
+            Broadcast(queued);
+        count += overflow.size();
     }
+
+    lastUpdatePackets = count * m_listeners.size();
+    num_packets += lastUpdatePackets;
 }
 
 void PlayerBroadcaster::QueuePacket(WorldPacket packet, bool self, ObjectGuid except)
 {
     BroadcastData data;
-    data.packet = std::move(packet);
+    data.packet = std::make_shared<WorldPacket const>(std::move(packet));
     data.sendToSelf = self;
     data.except = except;
 
-    std::unique_lock<std::mutex> guard(m_queue_lock, std::defer_lock);
+    // Once something overflowed, keep queuing there until the consumer caught up, to keep the order
+    if (!m_overflow_size && m_queue.push(std::move(data)))
+        return;
 
-    guard.lock();
+    std::lock_guard<std::mutex> guard(m_overflow_lock);
 
     // We need to drop a packet here - if possible
-    if (m_queue.size() >= MAX_QUEUE_SIZE)
+    if (m_overflow.size() >= MAX_QUEUE_SIZE)
     {
-        BroadcastData& last_in_queue = m_queue[m_queue.size() - 1];
-        if (CanSkipPacket(last_in_queue.packet.GetOpcode()) && CanSkipPacket(packet.GetOpcode()))
+        BroadcastData& last_in_queue = m_overflow.back();
+        if (CanSkipPacket(last_in_queue.packet->GetOpcode()) && CanSkipPacket(data.packet->GetOpcode()))
         {
-            m_queue[m_queue.size() - 1] = std::move(data);
-            guard.unlock();
+            last_in_queue = std::move(data);
             return;
         }
     }
-    m_queue.emplace_back(std::move(data));
-
-    guard.unlock();
+    m_overflow.emplace_back(std::move(data));
+    m_overflow_size = m_overflow.size();
 }
 
 ObjectGuid PlayerBroadcaster::GetGUID() const
@@ -121,8 +169,24 @@ void PlayerBroadcaster::FreeAtLogout()
         m_socket->RemoveReference();
         m_socket = nullptr;
     }
-    std::unique_lock<std::mutex> q_g(m_queue_lock), v_g(m_listeners_lock);
-    m_queue.clear();
+
+    // Take the consumer role to empty the ring
+    std::lock_guard<std::mutex> guard(m_process_lock);
+    BroadcastData data;
+    while (m_queue.pop(data))
+        ;
+    {
+        std::lock_guard<std::mutex> o_g(m_overflow_lock);
+        m_overflow.clear();
+        m_overflow_size = 0;
+    }
+    {
+        std::lock_guard<std::mutex> l_g(m_listeners_lock);
+        m_listener_changes.clear();
+        m_clear_listeners = false;
+        m_listeners_changed = false;
+    }
+    // Listeners hold references to each other: clear them to break the cycles
     m_listeners.clear();
 }
 
@@ -4,8 +4,11 @@
 #include "ObjectGuid.h"
 #include "WorldPacket.h"
 #include "WorldSocket.h"
-#include "WorldPacket.h"
 #include "Opcodes.h"
+#include "Utilities/RingBuffer.h"
+#include <atomic>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <list>
 #include <vector>
@@ -16,25 +19,43 @@ class Player;
 
 class PlayerBroadcaster final
 {
+    // Packets are immutable once queued: serialized once, then shared by every listener
     struct BroadcastData
     {
-        WorldPacket packet;
+        BroadcastData() : sendToSelf(false) {}
+        std::shared_ptr<WorldPacket const> packet;
         bool sendToSelf;
         ObjectGuid except;
     };
 
+    typedef std::map<ObjectGuid, std::shared_ptr<PlayerBroadcaster> > ListenersMap;
+
     const std::size_t MAX_QUEUE_SIZE;
 
     WorldSocket* m_socket;
     ObjectGuid m_self;
 
-    std::map<ObjectGuid, std::shared_ptr<PlayerBroadcaster> > m_listeners;
-    std::vector<BroadcastData> m_queue;
+    // Producers: map threads. Consumer: the movement broadcaster thread.
+    MPSCRingBuffer<BroadcastData> m_queue;
+    // Used only when the ring is full, keeps the packets ordered until the next ProcessQueue
+    std::vector<BroadcastData> m_overflow;
+    std::atomic<std::size_t> m_overflow_size;
+    std::mutex m_overflow_lock;
+
+    // Owned by the consumer, changes are posted in m_listener_changes (null = removal)
+    ListenersMap m_listeners;
+    ListenersMap m_listener_changes;
+    bool m_clear_listeners;
+    std::atomic<bool> m_listeners_changed;
     std::mutex m_listeners_lock;
-    std::mutex m_queue_lock;
+
+    // Held by the consumer while processing, and at logout
+    std::mutex m_process_lock;
 
     void ProcessQueue(uint32& num_packets);
-    void SendPacket(const WorldPacket& packet);
+    void ApplyListenerChanges();
+    void Broadcast(BroadcastData const& data);
+    void SendPacket(std::shared_ptr<WorldPacket const> const& packet);
 
     static inline bool CanSkipPacket(uint32 opcode)
     {
@@ -29,10 +29,28 @@
 #include "AddonHandler.h"
 
 #include "Opcodes.h"
+#include "UpdateData.h"
 #include "MangosSocketImpl.h"
 
 template class MangosSocket<WorldSession, WorldSocket, AuthCrypt>;
 
+bool WorldSocket::PrepareQueuedPacket(WorldPacket& pct)
+{
+    if (!pct.IsCompressionPending())
+        return true;
+
+    if (!PacketCompressor::CompressPendingPacket(pct))
+        return false;
+
+    // There is a maximum size packet.
+    if (pct.size() > 0x8000)
+    {
+        sLog.outInfo("[NETWORK] Packet %s size %u is too large. Not sent [IP %s]", LookupOpcodeName(pct.GetOpcode()), pct.size(), GetRemoteAddress().c_str());
+        return false;
+    }
+    return true;
+}
+
 int WorldSocket::ProcessIncoming(WorldPacket* new_pct)
 {
     MANGOS_ASSERT(new_pct);
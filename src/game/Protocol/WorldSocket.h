@@ -46,6 +46,9 @@ class WorldSocket: public MangosSocket<WorldSession, WorldSocket, AuthCrypt>
 
         int ProcessIncoming (WorldPacket* new_pct);
 
+        /// Compresses the update packets left uncompressed by the map threads.
+        bool PrepareQueuedPacket(WorldPacket& pct);
+
         /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
         int HandleAuthSession (WorldPacket& recvPacket);
 
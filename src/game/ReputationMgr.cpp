@@ -434,19 +434,16 @@ void ReputationMgr::LoadFromDB(QueryResult *result)
 
 void ReputationMgr::SaveToDB()
 {
-    static SqlStatementID delRep ;
-    static SqlStatementID insRep ;
-
-    SqlStatement stmtDel = CharacterDatabase.CreateStatement(delRep, "DELETE FROM character_reputation WHERE guid = ? AND faction=?");
-    SqlStatement stmtIns = CharacterDatabase.CreateStatement(insRep, "INSERT INTO character_reputation (guid,faction,standing,flags) VALUES (?, ?, ?, ?)");
+    SqlInsertBatch batch(CharacterDatabase, "INSERT INTO character_reputation (guid,faction,standing,flags)",
+        "ON DUPLICATE KEY UPDATE standing = VALUES(standing), flags = VALUES(flags)");
 
     for (FactionStateList::iterator itr = m_factions.begin(); itr != m_factions.end(); ++itr)
     {
         if (itr->second.needSave)
         {
-            stmtDel.PExecute(m_player->GetGUIDLow(), itr->second.ID);
-            stmtIns.PExecute(m_player->GetGUIDLow(), itr->second.ID, itr->second.Standing, itr->second.Flags);
+            batch.NewRow() << m_player->GetGUIDLow() << ", " << itr->second.ID << ", " << itr->second.Standing << ", " << itr->second.Flags;
             itr->second.needSave = false;
         }
     }
+    batch.Flush();
 }
@@ -49,6 +49,8 @@
 #include "CharacterDatabaseCache.h"
 #include "GameObjectAI.h"
 
+#include <memory>
+
 #define SPELL_CHANNEL_UPDATE_INTERVAL (1 * IN_MILLISECONDS)
 
 extern pEffect SpellEffects[TOTAL_SPELL_EFFECTS];
@@ -605,9 +607,10 @@ void Spell::FillTargetMap()
             }
         }
 
+        bool losChecked = FilterTargetsInLos(tmpUnitMap, SpellEffectIndex(i));
         for (UnitList::iterator itr = tmpUnitMap.begin(); itr != tmpUnitMap.end();)
         {
-            if (!CheckTarget(*itr, SpellEffectIndex(i)))
+            if (!CheckTarget(*itr, SpellEffectIndex(i), !losChecked))
             {
                 itr = tmpUnitMap.erase(itr);
                 continue;
@@ -1780,7 +1783,7 @@ void Spell::SetTargetMap(SpellEffectIndex effIndex, uint32 targetMode, UnitList&
             {
                 MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(m_caster, max_range);
                 MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(tempTargetUnitMap, u_check);
-                Cell::VisitAllObjects(m_caster, searcher, max_range);
+                Cell::VisitUnitsInRange(m_caster, searcher, max_range, true);
             }
 
             if (tempTargetUnitMap.empty())
@@ -6843,7 +6846,74 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
         return (CURRENT_GENERIC_SPELL);
 }
 
-bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
+// Removes the targets out of line of sight of the casting object, with one batched
+// vmap query for all of them. Returns false if CheckTarget has to test it instead.
+bool Spell::FilterTargetsInLos(UnitList& targetUnitMap, SpellEffectIndex eff)
+{
+    if (targetUnitMap.size() < 2 || (m_spellInfo->AttributesEx2 & SPELL_ATTR_EX2_IGNORE_LOS))
+        return false;
+
+    // Only the normal case of CheckTarget
+    switch (m_spellInfo->Effect[eff])
+    {
+        case SPELL_EFFECT_SUMMON_PLAYER:
+        case SPELL_EFFECT_DUMMY:
+        case SPELL_EFFECT_RESURRECT_NEW:
+            return false;
+    }
+
+    WorldObject* caster = GetCastingObject();
+    if (!caster || !caster->IsInWorld())
+        return false;
+
+    float cx, cy, cz;
+    caster->GetPosition(cx, cy, cz);
+
+    // Same shortcuts as WorldObject::IsWithinLOSInMap, the other targets get a ray
+    enum { LOS_KEEP = -1, LOS_REMOVE = -2 };
+    std::vector<int32> state;
+    std::vector<float> from, to;
+    state.reserve(targetUnitMap.size());
+    from.reserve(targetUnitMap.size() * 3);
+    to.reserve(targetUnitMap.size() * 3);
+    for (UnitList::const_iterator itr = targetUnitMap.begin(); itr != targetUnitMap.end(); ++itr)
+    {
+        Unit* target = *itr;
+        if (target == m_caster)
+            state.push_back(LOS_KEEP);
+        else if (!target->IsInMap(caster))
+            state.push_back(LOS_REMOVE);
+        else if (target->IsWithinDist(caster, 0.0f) || !target->IsInWorld())
+            state.push_back(LOS_KEEP);
+        else
+        {
+            state.push_back(from.size() / 3);
+            from.push_back(target->GetPositionX());
+            from.push_back(target->GetPositionY());
+            from.push_back(target->GetPositionZ() + 2.f);
+            to.push_back(cx);
+            to.push_back(cy);
+            to.push_back(cz + 2.f);
+        }
+    }
+
+    uint32 rays = from.size() / 3;
+    std::unique_ptr<bool[]> inLos(new bool[rays]);
+    if (rays)
+        caster->GetMap()->isInLineOfSight(from.data(), to.data(), rays, inLos.get());
+
+    uint32 i = 0;
+    for (UnitList::iterator itr = targetUnitMap.begin(); itr != targetUnitMap.end(); ++i)
+    {
+        if (state[i] == LOS_REMOVE || (state[i] >= 0 && !inLos[state[i]]))
+            itr = targetUnitMap.erase(itr);
+        else
+            ++itr;
+    }
+    return true;
+}
+
+bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff, bool checkLos)
 {
     if (target != m_caster && IsPositiveSpell(m_spellInfo))
     {
@@ -6922,7 +6992,7 @@ bool Spell::CheckTarget(Unit* target, SpellEffectIndex eff)
             break;
         default:                                            // normal case
             // Get GO cast coordinates if original caster -> GO
-            if (target != m_caster)
+            if (checkLos && target != m_caster)
                 if (WorldObject *caster = GetCastingObject())
                     if (!(m_spellInfo->AttributesEx2 & SPELL_ATTR_EX2_IGNORE_LOS) && !target->IsWithinLOSInMap(caster))
                         return false;
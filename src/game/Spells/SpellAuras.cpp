@@ -598,7 +598,7 @@ void AreaAura::Update(uint32 diff)
                 {
                     MaNGOS::AnyAoETargetUnitInObjectRangeCheck u_check(caster, m_radius); // No GetCharmer in searcher
                     MaNGOS::UnitListSearcher<MaNGOS::AnyAoETargetUnitInObjectRangeCheck> searcher(targets, u_check);
-                    Cell::VisitAllObjects(caster, searcher, m_radius);
+                    Cell::VisitUnitsInRange(caster, searcher, m_radius, true);
                     break;
                 }
                 case AREA_AURA_OWNER:
@@ -29,7 +29,7 @@
 #include "MapManager.h"
 #include "Unit.h"
 
-SpellMgr::SpellMgr()
+SpellMgr::SpellMgr() : mSpellProcEventsGeneration(0)
 {
 }
 
@@ -1341,6 +1341,7 @@ struct DoSpellProcEvent
 void SpellMgr::LoadSpellProcEvents()
 {
     mSpellProcEventMap.clear();                             // need for reload case
+    ++mSpellProcEventsGeneration;
 
     //                                                0      1           2                3                 4                 5                 6          7       8        9             10
     QueryResult *result = WorldDatabase.Query("SELECT entry, SchoolMask, SpellFamilyName, SpellFamilyMask0, SpellFamilyMask1, SpellFamilyMask2, procFlags, procEx, ppmRate, CustomChance, Cooldown FROM spell_proc_event");
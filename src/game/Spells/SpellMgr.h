@@ -993,6 +993,8 @@ class SpellMgr
                 return &itr->second;
             return NULL;
         }
+        // Changes at each (re)load of spell_proc_event, see Unit::m_procAuraHolders
+        uint32 GetSpellProcEventsGeneration() const { return mSpellProcEventsGeneration; }
 
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
@@ -1261,6 +1263,7 @@ class SpellMgr
         SpellElixirMap     mSpellElixirs;
         SpellThreatMap     mSpellThreatMap;
         SpellProcEventMap  mSpellProcEventMap;
+        uint32             mSpellProcEventsGeneration;
         SpellProcItemEnchantMap mSpellProcItemEnchantMap;
         SpellBonusMap      mSpellBonusMap;
         SkillLineAbilityMap mSkillLineAbilityMap;
@@ -26,6 +26,7 @@
 #include "ObjectAccessor.h"
 #include "UnitEvents.h"
 #include "TargetedMovementGenerator.h"
+#include <algorithm>
 
 //==============================================================
 //================= ThreatCalcHelper ===========================
@@ -208,6 +209,30 @@ void ThreatContainer::clearReferences()
         delete(*i);
     }
     iThreatList.clear();
+    iRefsByGuid.clear();
+}
+
+//============================================================
+
+void ThreatContainer::addReference(HostileReference* pHostileReference)
+{
+    iThreatList.push_back(pHostileReference);
+    iRefsByGuid[pHostileReference->getUnitGuid()] = pHostileReference;
+}
+
+//============================================================
+
+void ThreatContainer::remove(HostileReference* pRef)
+{
+    ThreatList::iterator itr = std::find(iThreatList.begin(), iThreatList.end(), pRef);
+    if (itr == iThreatList.end())
+        return;
+
+    // Keep the order: the list may not be dirty
+    iThreatList.erase(itr);
+    std::unordered_map<ObjectGuid, HostileReference*>::iterator guidItr = iRefsByGuid.find(pRef->getUnitGuid());
+    if (guidItr != iRefsByGuid.end() && guidItr->second == pRef)
+        iRefsByGuid.erase(guidItr);
 }
 
 //============================================================
@@ -217,18 +242,8 @@ HostileReference* ThreatContainer::getReferenceByTarget(Unit* pVictim)
     if (!pVictim)
         return nullptr;
 
-    HostileReference* result = nullptr;
-    ObjectGuid guid = pVictim->GetObjectGuid();
-    for (ThreatList::const_iterator i = iThreatList.begin(); i != iThreatList.end(); ++i)
-    {
-        if ((*i)->getUnitGuid() == guid)
-        {
-            result = (*i);
-            break;
-        }
-    }
-
-    return result;
+    std::unordered_map<ObjectGuid, HostileReference*>::const_iterator itr = iRefsByGuid.find(pVictim->GetObjectGuid());
+    return itr != iRefsByGuid.end() ? itr->second : nullptr;
 }
 
 //============================================================
@@ -263,19 +278,24 @@ void ThreatContainer::modifyThreatPercent(Unit *pVictim, int32 pPercent)
 
 //============================================================
 
-bool HostileReferenceSortPredicate(const HostileReference* lhs, const HostileReference* rhs)
-{
-    // std::list::sort ordering predicate must be: (Pred(x,y)&&Pred(y,x))==false
-    return lhs->getThreat() > rhs->getThreat();             // reverse sorting
-}
-
-//============================================================
 // Check if the list is dirty and sort if necessary
+// Between two updates only a few references change of place: an insertion sort is
+// about linear there. It is stable, references with the same threat keep their order.
 
 void ThreatContainer::update()
 {
     if (iDirty && iThreatList.size() > 1)
-        iThreatList.sort(HostileReferenceSortPredicate);
+    {
+        for (size_t i = 1; i < iThreatList.size(); ++i)
+        {
+            HostileReference* ref = iThreatList[i];
+            float threat = ref->getThreat();
+            size_t j = i;
+            for (; j > 0 && iThreatList[j - 1]->getThreat() < threat; --j)
+                iThreatList[j] = iThreatList[j - 1];
+            iThreatList[j] = ref;
+        }
+    }
     iDirty = false;
 }
 
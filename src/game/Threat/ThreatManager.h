@@ -25,7 +25,8 @@
 #include "Utilities/LinkedReference/Reference.h"
 #include "UnitEvents.h"
 #include "ObjectGuid.h"
-#include <list>
+#include <vector>
+#include <unordered_map>
 
 //==============================================================
 
@@ -132,17 +133,20 @@ class MANGOS_DLL_SPEC HostileReference : public Reference<Unit, ThreatManager>
 //==============================================================
 class ThreatManager;
 
-typedef std::list<HostileReference*> ThreatList;
+// Adding a reference to a container (new hated unit, back online) invalidates its iterators.
+// Raising the threat of a pet adds its owner, so loops changing threat iterate a copy.
+typedef std::vector<HostileReference*> ThreatList;
 
 class MANGOS_DLL_SPEC ThreatContainer
 {
-    ThreatList iThreatList;
+    ThreatList iThreatList;                                 // by decreasing threat after update()
+    std::unordered_map<ObjectGuid, HostileReference*> iRefsByGuid;
     bool iDirty;
 protected:
     friend class ThreatManager;
 
-    void remove(HostileReference* pRef) { iThreatList.remove(pRef); }
-    void addReference(HostileReference* pHostileReference) { iThreatList.push_back(pHostileReference); }
+    void remove(HostileReference* pRef);
+    void addReference(HostileReference* pHostileReference);
     void clearReferences();
     // Sort the list if necessary
     void update();
@@ -234,6 +234,7 @@ inline bool SpellCanTrigger(const SpellEntry* spellProto, const SpellEntry* proc
     return (procSpell && procSpell->SpellFamilyName == spellProto->SpellFamilyName && procSpell->SpellFamilyFlags & spellProto->EffectItemType[eff_idx]);
 }
 
+// Keep GetSpellProcMask in sync with the hardcoded cases
 bool Unit::IsTriggeredAtSpellProcEvent(Unit *pVictim, SpellAuraHolder* holder, SpellEntry const* procSpell, uint32 procFlag, uint32 procExtra, WeaponAttackType attType, bool isVictim, SpellProcEventEntry const*& spellProcEvent)
 {
     SpellEntry const* spellProto = holder->GetSpellProto();
@@ -395,6 +396,22 @@ bool Unit::IsTriggeredAtSpellProcEvent(Unit *pVictim, SpellAuraHolder* holder, S
     return roll_chance_f(chance);
 }
 
+uint32 Unit::GetSpellProcMask(SpellEntry const* spellProto)
+{
+    // Hardcoded in IsTriggeredAtSpellProcEvent, whatever their proc flags: Redoubt, Eye for an Eye,
+    // Improved Lay on Hands, Inspiration, SPELL_AURA_ADD_TARGET_TRIGGER
+    if ((spellProto->SpellIconID == 28 && spellProto->SpellFamilyName == 0) ||
+            spellProto->SpellIconID == 1820 ||
+            (spellProto->SpellIconID == 79 && (spellProto->SpellFamilyName == SPELLFAMILY_PALADIN || spellProto->SpellFamilyName == SPELLFAMILY_PRIEST)) ||
+            spellProto->EffectApplyAuraName[0] == SPELL_AURA_ADD_TARGET_TRIGGER)
+        return 0xFFFFFFFF;
+
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(spellProto->Id);
+    if (spellProcEvent && spellProcEvent->procFlags)
+        return spellProcEvent->procFlags;
+    return spellProto->procFlags;
+}
+
 SpellAuraProcResult Unit::HandleHasteAuraProc(Unit *pVictim, uint32 damage, Aura* triggeredByAura, SpellEntry const * /*procSpell*/, uint32 /*procFlag*/, uint32 /*procEx*/, uint32 cooldown)
 {
     return SPELL_AURA_PROC_OK;
@@ -448,6 +448,78 @@ Weather* World::AddWeather(uint32 zone_id)
     return w;
 }
 
+// Reads every field of every row like loaders do, returns a checksum of the values
+static uint64 ReadBenchmarkResult(QueryResult* result)
+{
+    uint64 checksum = 0;
+    if (!result)
+        return checksum;
+
+    do
+    {
+        Field* fields = result->Fetch();
+        for (uint32 i = 0; i < result->GetFieldCount(); ++i)
+        {
+            switch (fields[i].GetType())
+            {
+                case Field::DB_TYPE_INTEGER:
+                    checksum += fields[i].GetUInt32();
+                    break;
+                case Field::DB_TYPE_FLOAT:
+                    checksum += uint64(int64(fields[i].GetFloat() * 100.0f));
+                    break;
+                default:
+                    checksum += fields[i].GetCppString().size();
+                    break;
+            }
+        }
+    }
+    while (result->NextRow());
+
+    return checksum;
+}
+
+void World::BenchmarkDatabaseResults()
+{
+    struct BenchmarkTable
+    {
+        Database* db;
+        char const* table;
+    };
+    BenchmarkTable const tables[] =
+    {
+        { &WorldDatabase,       "creature" },
+        { &WorldDatabase,       "gameobject" },
+        { &CharacterDatabase,   "item_instance" },
+        { &CharacterDatabase,   "character_inventory" },
+    };
+
+    sLog.outString("Benchmarking database results (text / binary)...");
+    for (BenchmarkTable const& table : tables)
+    {
+        std::string sql = std::string("SELECT * FROM ") + table.table;
+
+        uint32 textTime = WorldTimer::getMSTime();
+        QueryResult* textResult = table.db->Query(sql.c_str());
+        uint64 rows = textResult ? textResult->GetRowCount() : 0;
+        uint64 textChecksum = ReadBenchmarkResult(textResult);
+        delete textResult;
+        textTime = WorldTimer::getMSTimeDiffToNow(textTime);
+
+        uint32 binaryTime = WorldTimer::getMSTime();
+        SqlStatementID stmtId;
+        SqlStatement stmt = table.db->CreateStatement(stmtId, sql.c_str());
+        QueryResult* binaryResult = stmt.Query();
+        uint64 binaryChecksum = ReadBenchmarkResult(binaryResult);
+        delete binaryResult;
+        binaryTime = WorldTimer::getMSTimeDiffToNow(binaryTime);
+
+        sLog.outString(">> %-20s " UI64FMTD " rows: text %ums, binary %ums%s", table.table, rows, textTime, binaryTime,
+                       textChecksum == binaryChecksum ? "" : " (VALUES DIFFER)");
+    }
+    sLog.outString();
+}
+
 /// Initialize config values
 void World::LoadConfigSettings(bool reload)
 {
@@ -562,11 +634,15 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_BOOL_COMPRESSION_DEFERRED, "Compression.Deferred", false);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
     setConfig(CONFIG_BOOL_CLEANUP_TERRAIN, "CleanupTerrain", true);
+    setConfig(CONFIG_BOOL_TERRAIN_MEMORY_MAPPED, "Terrain.MemoryMapped", false);
+    setConfig(CONFIG_BOOL_TERRAIN_PREFETCH, "Terrain.Prefetch", false);
     setConfigPos(CONFIG_UINT32_INTERVAL_SAVE, "PlayerSave.Interval", 15 * MINUTE * IN_MILLISECONDS);
+    setConfig(CONFIG_UINT32_SAVE_MAX_DATABASE_QUEUE, "PlayerSave.MaxDatabaseQueue", 0);
     setConfigMinMax(CONFIG_UINT32_MIN_LEVEL_STAT_SAVE, "PlayerSave.Stats.MinLevel", 0, 0, MAX_LEVEL);
     setConfig(CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT, "PlayerSave.Stats.SaveOnlyOnLogout", true);
 
@@ -794,6 +870,11 @@ void World::LoadConfigSettings(bool reload)
         m_VisibleObjectGreyDistance = MAX_VISIBILITY_DISTANCE;
     }
 
+    setConfig(CONFIG_BOOL_VISIBILITY_INCREMENTAL,           "Visibility.Incremental", false);
+    setConfig(CONFIG_BOOL_VISIBILITY_INCREMENTAL_CHECK,     "Visibility.Incremental.Check", false);
+    setConfigPos(CONFIG_FLOAT_VISIBILITY_INCREMENTAL_NEAR,  "Visibility.Incremental.NearDistance", 40.0f);
+    setConfigPos(CONFIG_FLOAT_VISIBILITY_INCREMENTAL_EDGE,  "Visibility.Incremental.EdgeDistance", 10.0f);
+
     //visibility on continents
     m_MaxVisibleDistanceOnContinents      = sConfig.GetFloatDefault("Visibility.Distance.Continents",     DEFAULT_VISIBILITY_DISTANCE);
     if (m_MaxVisibleDistanceOnContinents < 45 * getConfig(CONFIG_FLOAT_RATE_CREATURE_AGGRO))
@@ -925,6 +1006,8 @@ void World::LoadNostalriusConfig(bool reload)
 
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
     sLog.outString("WORLD: mmap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
+    setConfig(CONFIG_BOOL_MMAP_ASYNC_PATHS, "mmap.async", false);
+    setConfig(CONFIG_UINT32_MMAP_PATH_CACHE_TIME, "mmap.async.CacheTime", 500);
 
     setConfigMinMax(CONFIG_UINT32_PET_DEFAULT_LOYALTY, "Pet.DefaultLoyalty", 1, 1, 6);
     setConfigMinMax(CONFIG_UINT32_MAP_OBJECTSUPDATE_THREADS,            "MapUpdate.ObjectsUpdate.MaxThreads", 4, 1, 20);
@@ -932,6 +1015,8 @@ void World::LoadNostalriusConfig(bool reload)
     setConfigMinMax(CONFIG_UINT32_MAP_VISIBILITYUPDATE_THREADS,         "MapUpdate.VisibilityUpdate.MaxThreads", 4, 1, 20);
     setConfigMinMax(CONFIG_UINT32_MAP_VISIBILITYUPDATE_TIMEOUT,         "MapUpdate.VisibilityUpdate.Timeout", 100, 10, 2000);
     setConfigMinMax(CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS,   "MapUpdate.Instanced.UpdateThreads", 2, 0, 20);
+    setConfigMinMax(CONFIG_UINT32_MAPUPDATE_WORKER_THREADS,             "MapUpdate.WorkerThreads", 0, 0, 64);
+    setConfig(CONFIG_BOOL_MAPUPDATE_PIN_WORKER_THREADS,                 "MapUpdate.WorkerThreads.PinToCores", false);
     setConfigMinMax(CONFIG_UINT32_MTCELLS_THREADS,                      "MapUpdate.Continents.MTCells.Threads", 0, 0, 20);
     setConfigMinMax(CONFIG_UINT32_MTCELLS_SAFEDISTANCE,                 "MapUpdate.Continents.MTCells.SafeDistance", 1066, 0, 34112);
     setConfigMinMax(CONFIG_UINT32_MAPUPDATE_UPDATE_PACKETS_DIFF,        "MapUpdate.UpdatePacketsDiff", 100, 1, 10000);
@@ -966,6 +1051,8 @@ void World::LoadNostalriusConfig(bool reload)
     setConfig(CONFIG_UINT32_PERFLOG_SLOW_MAP_PACKETS,           "PerformanceLog.SlowMapPackets", 60);
     setConfig(CONFIG_UINT32_PERFLOG_SLOW_SESSIONS_UPDATE,       "PerformanceLog.SlowSessionsUpdate", 0);
     setConfig(CONFIG_UINT32_PERFLOG_SLOW_PACKET_BCAST,          "PerformanceLog.SlowPacketBroadcast", 0);
+    setConfig(CONFIG_UINT32_PERFLOG_PROFILE_DUMP_INTERVAL,      "PerformanceLog.ProfileDumpInterval", 300);
+    setConfig(CONFIG_BOOL_PERFLOG_DATABASE_BENCHMARK,           "PerformanceLog.DatabaseBenchmark", false);
     setConfig(CONFIG_UINT32_CONTINENTS_MOTIONUPDATE_THREADS,                "Continents.MotionUpdate.Threads", 0);
     setConfig(CONFIG_BOOL_TERRAIN_PRELOAD_CONTINENTS,                   "Terrain.Preload.Continents", 1);
     setConfig(CONFIG_BOOL_TERRAIN_PRELOAD_INSTANCES,                    "Terrain.Preload.Instances", 1);
@@ -1101,6 +1188,9 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading saved variables ...");
     sObjectMgr.LoadSavedVariable();
 
+    if (getConfig(CONFIG_BOOL_PERFLOG_DATABASE_BENCHMARK))
+        BenchmarkDatabaseResults();
+
     ///- Update the realm entry in the database with the realm type from the config file
     //No SQL injection as values are treated as integers
 
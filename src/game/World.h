@@ -129,6 +129,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MTCELLS_THREADS,
     CONFIG_UINT32_MTCELLS_SAFEDISTANCE,
     CONFIG_UINT32_MAPUPDATE_INSTANCED_UPDATE_THREADS,
+    CONFIG_UINT32_MAPUPDATE_WORKER_THREADS,
     CONFIG_UINT32_MAPUPDATE_UPDATE_PACKETS_DIFF,
     CONFIG_UINT32_MAPUPDATE_UPDATE_PLAYERS_DIFF,
     CONFIG_UINT32_MAPUPDATE_UPDATE_CELLS_DIFF,
@@ -151,6 +152,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_PERFLOG_SLOW_PACKET,
     CONFIG_UINT32_PERFLOG_SLOW_MAP_PACKETS,
     CONFIG_UINT32_PERFLOG_SLOW_PACKET_BCAST,
+    CONFIG_UINT32_PERFLOG_PROFILE_DUMP_INTERVAL,
     CONFIG_UINT32_ASYNC_QUERIES_TICK_TIMEOUT,
     CONFIG_UINT32_LOGIN_PER_TICK,
     CONFIG_UINT32_ANTICRASH_REARM_TIMER,
@@ -164,6 +166,8 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MAP_VISIBILITYUPDATE_THREADS,
     CONFIG_UINT32_MAP_VISIBILITYUPDATE_TIMEOUT,
     CONFIG_UINT32_INTERVAL_SAVE,
+    CONFIG_UINT32_SAVE_MAX_DATABASE_QUEUE,
+    CONFIG_UINT32_MMAP_PATH_CACHE_TIME,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
@@ -365,6 +369,8 @@ enum eConfigFloatValues
     CONFIG_FLOAT_THREAT_RADIUS,
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
+    CONFIG_FLOAT_VISIBILITY_INCREMENTAL_NEAR,
+    CONFIG_FLOAT_VISIBILITY_INCREMENTAL_EDGE,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -392,10 +398,14 @@ enum eConfigBoolValues
     CONFIG_BOOL_SMARTLOG_SCRIPTINFO,
     CONFIG_BOOL_TERRAIN_PRELOAD_CONTINENTS,
     CONFIG_BOOL_TERRAIN_PRELOAD_INSTANCES,
+    CONFIG_BOOL_MAPUPDATE_PIN_WORKER_THREADS,
     CONFIG_BOOL_CLEANUP_TERRAIN,
+    CONFIG_BOOL_TERRAIN_MEMORY_MAPPED,
+    CONFIG_BOOL_TERRAIN_PREFETCH,
     CONFIG_BOOL_OUTDOORPVP_EP_ENABLE,
     CONFIG_BOOL_OUTDOORPVP_SI_ENABLE,
     CONFIG_BOOL_MMAP_ENABLED,
+    CONFIG_BOOL_MMAP_ASYNC_PATHS,
     CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_BOOL_ALLOW_TWO_SIDE_ACCOUNTS,
     CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_CHAT,
@@ -424,6 +434,7 @@ enum eConfigBoolValues
     CONFIG_BOOL_CHAT_STRICT_LINK_CHECKING_SEVERITY,
     CONFIG_BOOL_CHAT_STRICT_LINK_CHECKING_KICK,
     CONFIG_BOOL_ADDON_CHANNEL,
+    CONFIG_BOOL_COMPRESSION_DEFERRED,
     CONFIG_BOOL_CORPSE_EMPTY_LOOT_SHOW,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVP,
     CONFIG_BOOL_DEATH_CORPSE_RECLAIM_DELAY_PVE,
@@ -445,6 +456,9 @@ enum eConfigBoolValues
     CONFIG_BOOL_ENABLE_MOVEMENT_INTERP,
     CONFIG_BOOL_WHISPER_RESTRICTION,
     CONFIG_BOOL_MAILSPAM_ITEM,
+    CONFIG_BOOL_VISIBILITY_INCREMENTAL,
+    CONFIG_BOOL_VISIBILITY_INCREMENTAL_CHECK,
+    CONFIG_BOOL_PERFLOG_DATABASE_BENCHMARK,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -769,6 +783,8 @@ class World
         void _UpdateGameTime();
         // callback for UpdateRealmCharacters
         void _UpdateRealmCharCount(QueryResult *resultCharCount, uint32 accountId);
+        // Times the loading of some big tables with text and binary (prepared statement) results
+        void BenchmarkDatabaseResults();
 
     private:
         void setConfig(eConfigUInt32Values index, char const* fieldname, uint32 defvalue);
@@ -91,6 +91,9 @@ WorldSession::WorldSession(uint32 id, WorldSocket *sock, AccountTypes sec, time_
     }
     else
         m_Address = "<BOT>";
+
+    for (int i = 0; i < PACKET_PROCESS_MAX_TYPE; ++i)
+        _clearRecvQueue[i] = false;
 }
 
 /// WorldSession destructor
@@ -136,8 +139,17 @@ char const* WorldSession::GetPlayerName() const
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
 {
-    // There is a maximum size packet.
-    if (packet->size() > 0x8000)
+    // Deferred compression is done by WorldSocket only
+    if (packet->IsCompressionPending() && (!m_Socket || m_masterSession))
+    {
+        WorldPacket compressed(*packet);
+        if (PacketCompressor::CompressPendingPacket(compressed))
+            SendPacket(&compressed);
+        return;
+    }
+
+    // There is a maximum size packet. Checked by the socket once compressed for deferred packets.
+    if (packet->size() > 0x8000 && !packet->IsCompressionPending())
     {
         // Packet will be rejected by client
         sLog.outInfo("[NETWORK] Packet %s size %u is too large. Not sent [Account %u Player %s]", LookupOpcodeName(packet->GetOpcode()), packet->size(), GetAccountId(), GetPlayerName());
@@ -450,7 +462,13 @@ bool WorldSession::CanProcessPackets() const
 void WorldSession::ProcessPackets(PacketFilter& updater)
 {
     WorldPacket* packet = nullptr;
+    if (_clearRecvQueue[updater.PacketProcessType()].exchange(false))
+        while (_recvQueue[updater.PacketProcessType()].next(packet))
+            delete packet;
+
     _receivedPacketType[updater.PacketProcessType()] = false;
+    // database writes of the handlers stay ordered with the saves of the character
+    SqlAsyncKey asyncKey(_player ? _player->GetGUIDLow() : 0);
     while (CanProcessPackets() && _recvQueue[updater.PacketProcessType()].next(packet, updater))
     {
         _receivedPacketType[updater.PacketProcessType()] = true;
@@ -602,9 +620,8 @@ void WorldSession::ProcessPackets(PacketFilter& updater)
 void WorldSession::ClearIncomingPacketsByType(PacketProcessing type)
 {
     ASSERT(type < PACKET_PROCESS_MAX_TYPE);
-    WorldPacket* data = nullptr;
-    while (_recvQueue[type].next(data))
-        delete data;
+    // The queue has a single consumer: only ProcessPackets may pop from it
+    _clearRecvQueue[type] = true;
 }
 
 void WorldSession::SetDisconnectedSession()
@@ -30,6 +30,9 @@
 #include "AuctionHouseMgr.h"
 #include "Item.h"
 #include "MapNodes/AbstractPlayer.h"
+#include "Utilities/RingBuffer.h"
+
+#include <atomic>
 
 struct ItemPrototype;
 struct AuctionEntry;
@@ -499,6 +502,7 @@ class MANGOS_DLL_SPEC WorldSession
         }
         SessionScriptsMap scripts;
 
+        // Any thread: the packets are dropped by the next ProcessPackets of this type
         void ClearIncomingPacketsByType(PacketProcessing type);
         inline bool HasRecentPacket(PacketProcessing type) const { return _receivedPacketType[type]; }
 
@@ -930,7 +934,9 @@ class MANGOS_DLL_SPEC WorldSession
         uint32 m_latency;
         uint32 m_Tutorials[ACCOUNT_TUTORIALS_COUNT];
         TutorialDataState m_tutorialState;
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue[PACKET_PROCESS_MAX_TYPE];
+        // Filled by the network thread (and nodes), each one emptied by a single world/map thread at a time
+        MPSCQueue<WorldPacket*> _recvQueue[PACKET_PROCESS_MAX_TYPE];
+        std::atomic<bool> _clearRecvQueue[PACKET_PROCESS_MAX_TYPE];
         bool _receivedPacketType[PACKET_PROCESS_MAX_TYPE];
 
         WardenInterface* m_warden;
@@ -344,6 +344,80 @@ class BIH
             }
         }
 
+        // Calls intersectCallback(entry) for every object whose leaf overlaps the box
+        template<typename BoxCallback>
+        void intersectBox(const AABox& box, BoxCallback& intersectCallback) const
+        {
+            const Vector3& lo = box.low();
+            const Vector3& hi = box.high();
+            for (int i = 0; i < 3; ++i)
+                if (hi[i] < bounds.low()[i] || lo[i] > bounds.high()[i])
+                    return;
+
+            uint32 stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = !!(tn & (1 << 29));
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            float tl = intBitsToFloat(tree[node + 1]);
+                            float tr = intBitsToFloat(tree[node + 2]);
+                            bool left = lo[axis] <= tl;
+                            bool right = hi[axis] >= tr;
+                            if (left && right)
+                            {
+                                stack[stackPos++] = offset + 3;
+                                node = offset;
+                            }
+                            else if (left)
+                                node = offset;
+                            else if (right)
+                                node = offset + 3;
+                            else
+                                break;              // box is between clip zones
+                            continue;
+                        }
+                        else
+                        {
+                            int n = tree[node + 1];
+                            while (n > 0)
+                            {
+                                intersectCallback(objects[offset]);
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else // BVH2 node (empty space cut off left and right)
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float tl = intBitsToFloat(tree[node + 1]);
+                        float tr = intBitsToFloat(tree[node + 2]);
+                        node = offset;
+                        if (tl > hi[axis] || tr < lo[axis])
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+
+                if (stackPos == 0)
+                    return;
+                node = stack[--stackPos];
+            }
+        }
+
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
 
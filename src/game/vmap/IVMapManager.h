@@ -64,6 +64,12 @@ namespace VMAP
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
+            Batched versions of isInLineOfSight and getHeight, for many queries close to each other.
+            Positions are count x,y,z triples, the results are the same as one call per position.
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, const float* from, const float* to, uint32 count, bool* results) = 0;
+            virtual void getHeights(unsigned int pMapId, const float* pos, uint32 count, float maxSearchDist, float* heights) = 0;
+            /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
             return a position, that is pReduceDist closer to the origin
             */
@@ -268,6 +268,191 @@ namespace VMAP
 
     //=========================================================
 
+    namespace
+    {
+        // Candidate models of a batch. The bounds are stored per axis so the loops
+        // testing one ray against all of them compile to SIMD code.
+        struct BatchCandidates
+        {
+            std::vector<uint32> entries;
+            std::vector<float> low[3];
+            std::vector<float> high[3];
+            std::vector<uint8> mask;
+
+            void clear()
+            {
+                entries.clear();
+                for (int i = 0; i < 3; ++i)
+                {
+                    low[i].clear();
+                    high[i].clear();
+                }
+            }
+        };
+
+        thread_local BatchCandidates t_batch;
+
+        // Bounds are widened a bit, the exact test is done by ModelInstance::intersectRay afterwards
+        const float BATCH_BOUND_EPSILON = 0.01f;
+    }
+
+    class BatchCollectCallback
+    {
+        public:
+            BatchCollectCallback(ModelInstance* val, bool checkLOS): prims(val), checkLOS(checkLOS) {}
+            void operator()(uint32 entry)
+            {
+                if (checkLOS && prims[entry].flags & MOD_NO_BREAK_LOS)
+                    return;
+
+                const AABox& bounds = prims[entry].getBounds();
+                t_batch.entries.push_back(entry);
+                for (int i = 0; i < 3; ++i)
+                {
+                    t_batch.low[i].push_back(bounds.low()[i] - BATCH_BOUND_EPSILON);
+                    t_batch.high[i].push_back(bounds.high()[i] + BATCH_BOUND_EPSILON);
+                }
+            }
+        protected:
+            ModelInstance* prims;
+            bool checkLOS;
+    };
+
+    bool StaticMapTree::collectBatchCandidates(const AABox& box, bool pCheckLOS) const
+    {
+        t_batch.clear();
+        BatchCollectCallback callback(iTreeValues, pCheckLOS);
+        iTree.intersectBox(box, callback);
+        if (t_batch.entries.size() > BATCH_MAX_CANDIDATES)
+            return false;
+
+        t_batch.mask.resize(t_batch.entries.size());
+        return true;
+    }
+
+    void StaticMapTree::getHeights(const Vector3* pPos, uint32 count, float maxSearchDist, float* heights) const
+    {
+        if (!count)
+            return;
+
+        Vector3 low = pPos[0];
+        Vector3 high = pPos[0];
+        for (uint32 i = 1; i < count; ++i)
+        {
+            low = low.min(pPos[i]);
+            high = high.max(pPos[i]);
+        }
+        low.z -= maxSearchDist;
+
+        if (!collectBatchCandidates(AABox(low, high), false))
+        {
+            for (uint32 i = 0; i < count; ++i)
+                heights[i] = getHeight(pPos[i], maxSearchDist);
+            return;
+        }
+
+        uint32 const size = t_batch.entries.size();
+        float const* lx = t_batch.low[0].data();
+        float const* ly = t_batch.low[1].data();
+        float const* lz = t_batch.low[2].data();
+        float const* hx = t_batch.high[0].data();
+        float const* hy = t_batch.high[1].data();
+        float const* hz = t_batch.high[2].data();
+        uint8* mask = t_batch.mask.data();
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            // vertical ray: a box is crossed when it contains x,y and overlaps [z - maxSearchDist, z]
+            float const x = pPos[i].x;
+            float const y = pPos[i].y;
+            float const top = pPos[i].z;
+            float const bottom = top - maxSearchDist;
+            for (uint32 j = 0; j < size; ++j)
+                mask[j] = (lx[j] <= x) & (hx[j] >= x) & (ly[j] <= y) & (hy[j] >= y) & (lz[j] <= top) & (hz[j] >= bottom);
+
+            G3D::Ray ray(pPos[i], Vector3(0, 0, -1));
+            float maxDist = maxSearchDist;
+            bool hit = false;
+            for (uint32 j = 0; j < size; ++j)
+                if (mask[j] && iTreeValues[t_batch.entries[j]].intersectRay(ray, maxDist, false))
+                    hit = true;
+
+            heights[i] = hit ? pPos[i].z - maxDist : G3D::inf();
+        }
+    }
+
+    void StaticMapTree::isInLineOfSight(const Vector3* pos1, const Vector3* pos2, uint32 count, bool* results) const
+    {
+        if (!count)
+            return;
+
+        Vector3 low = pos1[0].min(pos2[0]);
+        Vector3 high = pos1[0].max(pos2[0]);
+        for (uint32 i = 1; i < count; ++i)
+        {
+            low = low.min(pos1[i]).min(pos2[i]);
+            high = high.max(pos1[i]).max(pos2[i]);
+        }
+
+        if (!collectBatchCandidates(AABox(low, high), true))
+        {
+            for (uint32 i = 0; i < count; ++i)
+                results[i] = isInLineOfSight(pos1[i], pos2[i]);
+            return;
+        }
+
+        uint32 const size = t_batch.entries.size();
+        float const* lo[3] = { t_batch.low[0].data(), t_batch.low[1].data(), t_batch.low[2].data() };
+        float const* hi[3] = { t_batch.high[0].data(), t_batch.high[1].data(), t_batch.high[2].data() };
+        uint8* mask = t_batch.mask.data();
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+            if (maxDist < 1e-10f)
+            {
+                results[i] = true;
+                continue;
+            }
+            Vector3 dir = (pos2[i] - pos1[i]) / maxDist;
+
+            // slab test of the segment against every box, with no division by zero for axis aligned rays
+            float org[3];
+            float invDir[3];
+            for (int a = 0; a < 3; ++a)
+            {
+                org[a] = pos1[i][a];
+                invDir[a] = fabs(dir[a]) > 1e-20f ? 1.0f / dir[a] : (dir[a] < 0.0f ? -1e20f : 1e20f);
+            }
+            for (uint32 j = 0; j < size; ++j)
+            {
+                float tNear = 0.0f;
+                float tFar = maxDist;
+                for (int a = 0; a < 3; ++a)
+                {
+                    float t1 = (lo[a][j] - org[a]) * invDir[a];
+                    float t2 = (hi[a][j] - org[a]) * invDir[a];
+                    tNear = std::max(tNear, std::min(t1, t2));
+                    tFar = std::min(tFar, std::max(t1, t2));
+                }
+                mask[j] = tNear <= tFar;
+            }
+
+            G3D::Ray ray = G3D::Ray::fromOriginAndDirection(pos1[i], dir);
+            bool inSight = true;
+            for (uint32 j = 0; j < size && inSight; ++j)
+            {
+                float dist = maxDist;
+                if (mask[j] && iTreeValues[t_batch.entries[j]].intersectRay(ray, dist, true, true))
+                    inSight = false;
+            }
+            results[i] = inSight;
+        }
+    }
+
+    //=========================================================
+
     bool StaticMapTree::CanLoadMap(const std::string& vmapPath, uint32 mapID, uint32 tileX, uint32 tileY)
     {
         std::string basePath = vmapPath;
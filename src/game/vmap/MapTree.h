@@ -58,6 +58,8 @@ namespace VMAP
 
         private:
             bool getIntersectionTime(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit = false, bool pCheckLOS = false) const;
+            // Fills the per thread candidate list with the models overlapping the box, false if there are too many of them
+            bool collectBatchCandidates(const G3D::AABox& box, bool pCheckLOS) const;
             // bool containsLoadedMapTile(unsigned int pTileIdent) const { return(iLoadedMapTiles.containsKey(pTileIdent)); }
         public:
             static std::string getTileFileName(uint32 mapID, uint32 tileX, uint32 tileY);
@@ -72,6 +74,13 @@ namespace VMAP
 			ModelInstance* FindCollisionModel(const G3D::Vector3& pos1, const G3D::Vector3& pos2);
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
+
+            // Batched queries: the tree is walked once for the bounding box of the whole batch,
+            // then each ray is only tested against the bounds of the models found there.
+            // Spread out batches, with too many models in their box, fall back to one walk per ray.
+            static const uint32 BATCH_MAX_CANDIDATES = 256;
+            void getHeights(const G3D::Vector3* pPos, uint32 count, float maxSearchDist, float* heights) const;
+            void isInLineOfSight(const G3D::Vector3* pos1, const G3D::Vector3* pos2, uint32 count, bool* results) const;
             bool getAreaInfo(G3D::Vector3& pos, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const;
 			bool isUnderModel(G3D::Vector3& pos, float* outDist = NULL, float* inDist = NULL) const;
             bool GetLocationInfo(const Vector3& pos, LocationInfo& info) const;
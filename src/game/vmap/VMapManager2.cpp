@@ -219,6 +219,52 @@ float VMapManager2::getHeight(unsigned int pMapId, float x, float y, float z, fl
 
 //=========================================================
 
+namespace
+{
+    // converted positions of the batch being processed by this thread
+    thread_local std::vector<Vector3> t_batchFrom;
+    thread_local std::vector<Vector3> t_batchTo;
+}
+
+void VMapManager2::isInLineOfSight(unsigned int pMapId, const float* from, const float* to, uint32 count, bool* results)
+{
+    std::fill(results, results + count, true);
+    if (!isLineOfSightCalcEnabled())
+        return;
+    InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+    if (instanceTree == iInstanceMapTrees.end())
+        return;
+
+    t_batchFrom.resize(count);
+    t_batchTo.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        t_batchFrom[i] = convertPositionToInternalRep(from[i * 3], from[i * 3 + 1], from[i * 3 + 2]);
+        t_batchTo[i] = convertPositionToInternalRep(to[i * 3], to[i * 3 + 1], to[i * 3 + 2]);
+    }
+    instanceTree->second->isInLineOfSight(t_batchFrom.data(), t_batchTo.data(), count, results);
+}
+
+void VMapManager2::getHeights(unsigned int pMapId, const float* pos, uint32 count, float maxSearchDist, float* heights)
+{
+    std::fill(heights, heights + count, VMAP_INVALID_HEIGHT_VALUE);
+    if (!isHeightCalcEnabled())
+        return;
+    InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
+    if (instanceTree == iInstanceMapTrees.end())
+        return;
+
+    t_batchFrom.resize(count);
+    for (uint32 i = 0; i < count; ++i)
+        t_batchFrom[i] = convertPositionToInternalRep(pos[i * 3], pos[i * 3 + 1], pos[i * 3 + 2]);
+    instanceTree->second->getHeights(t_batchFrom.data(), count, maxSearchDist, heights);
+    for (uint32 i = 0; i < count; ++i)
+        if (!(heights[i] < G3D::inf()))
+            heights[i] = VMAP_INVALID_HEIGHT_VALUE;     // no height
+}
+
+//=========================================================
+
 bool VMapManager2::getAreaInfo(unsigned int pMapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
 {
     bool result = false;
@@ -410,6 +410,7 @@ int Master::Run()
         sWorldSocketMgr->SetOutUBuff(sConfig.GetIntDefault("Network.OutUBuff", 65536));
         sWorldSocketMgr->SetThreads(sConfig.GetIntDefault("Network.Threads", 1) + 1);
         sWorldSocketMgr->SetInterval(sConfig.GetIntDefault("Network.Interval", 10));
+        sWorldSocketMgr->SetCorkDelay(sConfig.GetIntDefault("Network.CorkDelay", 0));
         sWorldSocketMgr->SetTcpNodelay(sConfig.GetBoolDefault("Network.TcpNodelay", true));
 
         if (sWorldSocketMgr->StartNetwork(wsport, bind_ip) == -1)
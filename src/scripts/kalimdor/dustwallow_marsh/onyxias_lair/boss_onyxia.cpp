@@ -201,6 +201,7 @@ struct boss_onyxiaAI : public ScriptedAI
         m_creature->SetSpeedRate(MOVE_RUN, ONYXIA_NORMAL_SPEED, true);
         m_creature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, 15.0f);
         m_creature->SetFloatValue(UNIT_FIELD_COMBATREACH, 16.0f);
+        m_creature->RefreshPositionCache();
 
         // Daemon: remise en mode "dort"
         m_creature->SetStandState(UNIT_STAND_STATE_SLEEP);
@@ -651,6 +652,7 @@ struct boss_onyxiaAI : public ScriptedAI
                 // increase Onyxia's hitbox while in the air to make it slightly easier for melee to use specials on her
                 m_creature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, 21.0f);
                 m_creature->SetFloatValue(UNIT_FIELD_COMBATREACH, 22.0f);
+                m_creature->RefreshPositionCache();
                 
                 m_pPointData = GetMoveData();
                 m_creature->GetMotionMaster()->MovePoint(m_pPointData->uiLocId, m_pPointData->fX, m_pPointData->fY, m_pPointData->fZ, MOVE_PATHFINDING | MOVE_FLY_MODE);
@@ -675,6 +677,7 @@ struct boss_onyxiaAI : public ScriptedAI
                 m_creature->RemoveAurasDueToSpell(17131); /** Stop flying */
                 m_creature->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, 15.0f);
                 m_creature->SetFloatValue(UNIT_FIELD_COMBATREACH, 16.0f);
+                m_creature->RefreshPositionCache();
                 m_uiTransTimer = 60000; // handled by MovementInform
             }
             /** Landing in progress */
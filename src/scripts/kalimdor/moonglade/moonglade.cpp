@@ -1414,7 +1414,8 @@ struct boss_eranikusAI : public ScriptedAI
 
         if (!m_creature->IsWithinMeleeRange(pTarget))
         {
-            ThreatList const& tList = m_creature->getThreatManager().getThreatList();
+            // Copy: raising the threat of a pet adds its owner to the list
+            ThreatList const tList = m_creature->getThreatManager().getThreatList();
             for (ThreatList::const_iterator itr = tList.begin(); itr != tList.end(); ++itr)
             {
                 if (Unit* pAttacker = m_creature->GetMap()->GetUnit((*itr)->getUnitGuid()))
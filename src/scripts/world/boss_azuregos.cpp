@@ -99,7 +99,8 @@ struct boss_azuregosAI : ScriptedAI
         {
             DoScriptText(SAY_TELEPORT, m_creature);
 
-            ThreatList const& tList = m_creature->getThreatManager().getThreatList();
+            // Copy: the teleport may change the list
+            ThreatList const tList = m_creature->getThreatManager().getThreatList();
             for (ThreatList::const_iterator i = tList.begin(); i != tList.end(); ++i)
             {
                 Unit* pUnit = m_creature->GetMap()->GetUnit((*i)->getUnitGuid());
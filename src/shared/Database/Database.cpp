@@ -30,6 +30,41 @@
 #define MIN_CONNECTION_POOL_SIZE 1
 #define MAX_CONNECTION_POOL_SIZE 16
 
+static thread_local uint32 t_asyncKey = 0;
+static thread_local uint32 t_asyncOtherKey = 0;
+static thread_local bool t_hasAsyncOtherKey = false;
+
+SqlAsyncKey::SqlAsyncKey(uint32 key) : m_previous(t_asyncKey), m_previousOther(t_asyncOtherKey), m_previousHasOther(t_hasAsyncOtherKey)
+{
+    t_asyncKey = key;
+    t_hasAsyncOtherKey = false;
+}
+
+SqlAsyncKey::SqlAsyncKey(uint32 key, uint32 otherKey) : m_previous(t_asyncKey), m_previousOther(t_asyncOtherKey), m_previousHasOther(t_hasAsyncOtherKey)
+{
+    t_asyncKey = key;
+    t_asyncOtherKey = otherKey;
+    t_hasAsyncOtherKey = true;
+}
+
+SqlAsyncKey::~SqlAsyncKey()
+{
+    t_asyncKey = m_previous;
+    t_asyncOtherKey = m_previousOther;
+    t_hasAsyncOtherKey = m_previousHasOther;
+}
+
+uint32 SqlAsyncKey::GetCurrent()
+{
+    return t_asyncKey;
+}
+
+bool SqlAsyncKey::GetCurrentOther(uint32& otherKey)
+{
+    otherKey = t_asyncOtherKey;
+    return t_hasAsyncOtherKey;
+}
+
 //////////////////////////////////////////////////////////////////////////
 SqlPreparedStatement * SqlConnection::CreateStatement( const std::string& fmt )
 {
@@ -132,6 +167,19 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id )
     return false;
 }
 
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if(nIndex == -1)
+        return NULL;
+
+    if (SqlPreparedStatement * pStmt = GetStmt(nIndex))
+    {
+        pStmt->bind(id);
+        return pStmt->query();
+    }
+    return NULL;
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
@@ -181,10 +229,11 @@ bool Database::Initialize(const char * infoString, int nConns /*= 1*/, int nWork
     if(!m_pAsyncConn->Initialize(infoString))
         return false;
 
-    m_numAsyncWorkers = nWorkers;
+    //operations are routed by key to the workers, there must be at least one
+    m_numAsyncWorkers = std::max(nWorkers, 1);
     m_threadsBodies   = new SqlDelayThread*[m_numAsyncWorkers];
     m_delayThreads    = new ACE_Based::Thread*[m_numAsyncWorkers];
-    for (int i = 0; i < nWorkers; ++i)
+    for (uint32 i = 0; i < m_numAsyncWorkers; ++i)
         if (!InitDelayThread(i, infoString))
             return false;
 
@@ -249,6 +298,66 @@ void Database::HaltDelayThread()
     m_numAsyncWorkers = 0;
 }
 
+void Database::AddToDelayQueue(SqlOperation* op)
+{
+    //workers are gone (server shutdown): nothing would ever run the operation
+    if (!m_threadsBodies)
+    {
+        if (m_pAsyncConn)
+        {
+            SqlConnection::Lock guard(m_pAsyncConn);
+            op->Execute(m_pAsyncConn);
+        }
+        delete op;
+        return;
+    }
+
+    SqlDelayThread* worker = m_threadsBodies[SqlAsyncKey::GetCurrent() % m_numAsyncWorkers];
+    uint32 otherKey;
+    if (SqlAsyncKey::GetCurrentOther(otherKey))
+    {
+        SqlDelayThread* otherWorker = m_threadsBodies[otherKey % m_numAsyncWorkers];
+        if (otherWorker != worker)
+        {
+            //both workers see the operations on two keys in the same order, so they can not wait on each other
+            std::shared_ptr<SqlKeysBarrier> barrier = std::make_shared<SqlKeysBarrier>();
+            std::lock_guard<std::mutex> guard(m_twoKeysLock);
+            otherWorker->Delay(new SqlKeysBarrierWait(barrier));
+            worker->Delay(new SqlKeysBarrierOperation(op, barrier));
+            return;
+        }
+    }
+
+    worker->Delay(op);
+}
+
+uint32 Database::GetAsyncQueueSize() const
+{
+    uint32 size = 0;
+    if (m_threadsBodies)
+        for (uint32 i = 0; i < m_numAsyncWorkers; ++i)
+            size += m_threadsBodies[i]->GetQueueSize();
+    return size;
+}
+
+void Database::DumpAsyncStats(char const* name)
+{
+    if (!m_threadsBodies)
+        return;
+
+    for (uint32 i = 0; i < m_numAsyncWorkers; ++i)
+    {
+        SqlDelayThread* worker = m_threadsBodies[i];
+        LatencyHistogram latency;
+        worker->GetLatency(latency);
+        if (latency.GetCount() || worker->GetQueueSize())
+            sLog.out(LOG_PROFILER, "%sDatabase worker %u: " UI64FMTD " operations, %u queued (max %u), p50 %uus p99 %uus max %uus",
+                name, i, latency.GetCount(), worker->GetQueueSize(), worker->GetMaxQueueSize(),
+                uint32(latency.GetPercentile(50)), uint32(latency.GetPercentile(99)), uint32(latency.GetMax()));
+        worker->ResetStats();
+    }
+}
+
 void Database::ThreadStart()
 {
 }
@@ -605,6 +714,14 @@ bool Database::DirectExecuteStmt( const SqlStatementID& id, SqlStmtParameters *
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters * params)
+{
+    MANGOS_ASSERT(params);
+    std::auto_ptr<SqlStmtParameters> p(params);
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char * fmt )
 {
     int nId = -1;
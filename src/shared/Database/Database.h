@@ -28,6 +28,7 @@
 #include <ace/TSS_T.h>
 #include <ace/Atomic_Op.h>
 #include "SqlPreparedStatement.h"
+#include <mutex>
 
 class SqlTransaction;
 class SqlResultQueue;
@@ -66,6 +67,7 @@ class MANGOS_DLL_SPEC SqlConnection
 
         //methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
 
         //SqlConnection object lock
         class Lock
@@ -111,6 +113,32 @@ class MANGOS_DLL_SPEC SqlConnection
         StmtHolder m_holder;
 };
 
+/**
+ * Routes the async operations queued by the current thread while in scope (executes,
+ * transactions, async queries) to the worker thread owning 'key', for every database.
+ * Operations with the same key run in order on one connection, operations with
+ * different keys may run in parallel when the database has several workers.
+ * Operations queued outside of any scope share key 0.
+ * Operations writing the data of two keys (trade, mail items ...) use both: they run
+ * after everything queued before them on either key and before anything queued after.
+ */
+class MANGOS_DLL_SPEC SqlAsyncKey
+{
+    public:
+        explicit SqlAsyncKey(uint32 key);
+        SqlAsyncKey(uint32 key, uint32 otherKey);
+        ~SqlAsyncKey();
+
+        static uint32 GetCurrent();
+        // False if the current scope has a single key
+        static bool GetCurrentOther(uint32& otherKey);
+
+    private:
+        uint32 m_previous;
+        uint32 m_previousOther;
+        bool m_previousHasOther;
+};
+
 class MANGOS_DLL_SPEC Database
 {
     public:
@@ -241,14 +269,19 @@ class MANGOS_DLL_SPEC Database
         //you should call it explicitly after your server successfully started up
         //NO ASYNC TRANSACTIONS DURING SERVER STARTUP - ONLY DURING RUNTIME!!!
         void AllowAsyncTransactions() { m_bAllowAsyncTransactions = true; }
-        inline void AddToDelayQueue(SqlOperation* op) { m_delayQueue->add(op); }
-        inline bool NextDelayedOperation(SqlOperation*& op) { return m_delayQueue->next(op); }
-        inline bool HasAsyncQuery() { return !(m_delayQueue->empty_unsafe()); }
+        //queues the operation on the worker owning the current async key (see SqlAsyncKey)
+        void AddToDelayQueue(SqlOperation* op);
+        inline bool HasAsyncQuery() const { return GetAsyncQueueSize() != 0; }
+        //async operations queued on all workers and not finished yet
+        uint32 GetAsyncQueueSize() const;
+        //writes queue sizes and latencies of the workers to the profiler log, then resets them
+        //latencies are the ones published by the workers at the previous reset
+        void DumpAsyncStats(char const* name);
 
         // Frees data, cancels scheduled queries, closes connection
         void StopServer();
     protected:
-        Database() : m_pAsyncConn(NULL), m_pResultQueue(NULL), m_threadsBodies(NULL), m_delayThreads(NULL), m_numAsyncWorkers(0), m_delayQueue(new SqlQueue()),
+        Database() : m_pAsyncConn(NULL), m_pResultQueue(NULL), m_threadsBodies(NULL), m_delayThreads(NULL), m_numAsyncWorkers(0),
             m_logSQL(false), m_pingIntervallms(0), m_nQueryConnPoolSize(1), m_bAllowAsyncTransactions(false), m_iStmtIndex(-1)
         {
             m_nQueryCounter = -1;
@@ -294,6 +327,7 @@ class MANGOS_DLL_SPEC Database
         //query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters * params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters * params);
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters * params);
 
         //connection helper counters
         int m_nQueryConnPoolSize;                               //current size of query connection pool
@@ -303,14 +337,12 @@ class MANGOS_DLL_SPEC Database
         typedef std::vector< SqlConnection * > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        typedef ACE_Based::LockedQueue<SqlOperation*, ACE_Thread_Mutex> SqlQueue;
-        SqlQueue* m_delayQueue;
-
         SqlConnection * m_pAsyncConn;
 
         SqlResultQueue *    m_pResultQueue;                  ///< Transaction queues from diff. threads
         uint32              m_numAsyncWorkers;
-        SqlDelayThread**    m_threadsBodies;                  ///< Pointer to delay sql executer (owned by m_delayThread)
+        SqlDelayThread**    m_threadsBodies;                  ///< Pointer to delay sql executer (owned by m_delayThread), each with its own queue
+        std::mutex          m_twoKeysLock;                    ///< Operations on two keys are queued in the same order on every worker
         ACE_Based::Thread** m_delayThreads;                   ///< Pointer to executer thread
 
         bool m_bAllowAsyncTransactions;                      ///< flag which specifies if async transactions are enabled
@@ -26,6 +26,7 @@
 
 #include "Database/Field.h"
 #include "Database/QueryResult.h"
+#include "Database/QueryResultBinary.h"
 
 #ifdef DO_POSTGRESQL
 #include "Database/QueryResultPostgre.h"
@@ -47,6 +48,8 @@ typedef DatabaseMysql DatabaseType;
 #define _OFFSET_         "LIMIT %d,1"
 #endif
 
+#include "Database/SqlInsertBatch.h"
+
 extern DatabaseType WorldDatabase;
 extern DatabaseType CharacterDatabase;
 extern DatabaseType LoginDatabase;
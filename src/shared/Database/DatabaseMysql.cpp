@@ -398,6 +398,7 @@ bool MySqlPreparedStatement::prepare()
         m_nColumns = mysql_num_fields(m_pResultMetadata);
 
         //bind output buffers
+        BindResult();
     }
 
     m_bPrepared = true;
@@ -466,6 +467,7 @@ void MySqlPreparedStatement::RemoveBinds()
 
     delete [] m_pInputArgs;
     delete [] m_pResult;
+    m_columns.clear();
 
     mysql_free_result(m_pResultMetadata);
     mysql_stmt_close(m_stmt);
@@ -493,6 +495,144 @@ bool MySqlPreparedStatement::execute()
     return true;
 }
 
+void MySqlPreparedStatement::BindResult()
+{
+    //longer strings are fetched separately
+    static const unsigned long MAX_TEXT_BUFFER = 1024;
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(m_pResultMetadata);
+
+    m_pResult = new MYSQL_BIND[m_nColumns];
+    memset(m_pResult, 0, sizeof(MYSQL_BIND) * m_nColumns);
+    m_columns.resize(m_nColumns);
+
+    for (uint32 i = 0; i < m_nColumns; ++i)
+    {
+        ResultColumn& column = m_columns[i];
+        MYSQL_BIND& bind = m_pResult[i];
+
+        column.type = ToFieldType(fields[i].type);
+        switch (column.type)
+        {
+            case Field::DB_TYPE_INTEGER:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.buffer = &column.integer;
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) ? 1 : 0;
+                break;
+            case Field::DB_TYPE_FLOAT:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &column.number;
+                break;
+            default:
+                column.text.resize(std::max(1ul, std::min(fields[i].length, MAX_TEXT_BUFFER)));
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &column.text[0];
+                bind.buffer_length = column.text.size();
+                break;
+        }
+        bind.length = &column.length;
+        bind.is_null = &column.isNull;
+        bind.error = &column.error;
+    }
+
+    if (mysql_stmt_bind_result(m_stmt, m_pResult))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed for '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+    }
+}
+
+QueryResult* MySqlPreparedStatement::query()
+{
+    if(!isPrepared() || !isQuery())
+        return NULL;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if(mysql_stmt_execute(m_stmt) || mysql_stmt_store_result(m_stmt))
+    {
+        sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        return NULL;
+    }
+
+    if(!mysql_stmt_num_rows(m_stmt))
+    {
+        mysql_stmt_free_result(m_stmt);
+        return NULL;
+    }
+
+    QueryResultBinary* result = new QueryResultBinary(m_nColumns);
+    for (uint32 i = 0; i < m_nColumns; ++i)
+        result->SetFieldType(i, m_columns[i].type);
+
+    int status;
+    while ((status = mysql_stmt_fetch(m_stmt)) == 0 || status == MYSQL_DATA_TRUNCATED)
+    {
+        result->AddRow();
+        for (uint32 i = 0; i < m_nColumns; ++i)
+        {
+            ResultColumn& column = m_columns[i];
+            if (column.isNull)
+                result->SetNull(i);
+            else if (column.type == Field::DB_TYPE_INTEGER)
+                result->SetInteger(i, column.integer);
+            else if (column.type == Field::DB_TYPE_FLOAT)
+                result->SetFloat(i, column.number);
+            else if (column.length <= column.text.size())
+                result->SetString(i, &column.text[0], column.length);
+            else
+            {
+                //did not fit in the column buffer
+                std::vector<char> text(column.length);
+                unsigned long length = 0;
+                MYSQL_BIND bind;
+                memset(&bind, 0, sizeof(bind));
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &text[0];
+                bind.buffer_length = text.size();
+                bind.length = &length;
+                mysql_stmt_fetch_column(m_stmt, &bind, i, 0);
+                result->SetString(i, &text[0], text.size());
+            }
+        }
+    }
+
+    if (status == 1)
+    {
+        sLog.outError("SQL: error while fetching rows of '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+    }
+
+    mysql_stmt_free_result(m_stmt);
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s,WorldTimer::getMSTime()), m_szFmt.c_str());
+
+    result->NextRow();
+    return result;
+}
+
+Field::DataTypes MySqlPreparedStatement::ToFieldType( enum_field_types mysqlType )
+{
+    switch (mysqlType)
+    {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_YEAR:
+            return Field::DB_TYPE_INTEGER;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+            return Field::DB_TYPE_FLOAT;
+        default:
+            return Field::DB_TYPE_STRING;
+    }
+}
+
 enum_field_types MySqlPreparedStatement::ToMySQLType( const SqlStmtFieldData &data, my_bool &bUnsigned )
 {
     bUnsigned = 0;
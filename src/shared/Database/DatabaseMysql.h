@@ -51,15 +51,34 @@ public:
     //execute DML statement
     virtual bool execute();
 
+    //execute SELECT statement, rows are fetched in binary form
+    virtual QueryResult* query();
+
 protected:
     //bind parameters
     void addParam(int nIndex, const SqlStmtFieldData& data);
+    //bind output buffers
+    void BindResult();
 
     static enum_field_types ToMySQLType( const SqlStmtFieldData &data, my_bool &bUnsigned );
+    static Field::DataTypes ToFieldType( enum_field_types mysqlType );
 
 private:
     void RemoveBinds();
 
+    //output buffer of a column: numbers are fetched as int64 or double, anything else as text
+    struct ResultColumn
+    {
+        Field::DataTypes type;
+        int64 integer;
+        double number;
+        std::vector<char> text;
+        unsigned long length;
+        my_bool isNull;
+        my_bool error;
+    };
+    std::vector<ResultColumn> m_columns;
+
     MYSQL * m_pMySQLConn;
     MYSQL_STMT * m_stmt;
     MYSQL_BIND * m_pInputArgs;
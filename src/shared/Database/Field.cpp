@@ -18,3 +18,12 @@
  */
 
 //#include "DatabaseEnv.h"
+#include "Field.h"
+
+void Field::FormatNumber() const
+{
+    if (mType == DB_TYPE_FLOAT)
+        snprintf(mText, sizeof(mText), "%.15g", mNumber.f);
+    else
+        snprintf(mText, sizeof(mText), SI64FMTD, mNumber.i);
+}
@@ -35,28 +35,42 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        Field() : mValue(NULL), mType(DB_TYPE_UNKNOWN), mBinary(false) { mNumber.i = 0; }
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mBinary(false) { mNumber.i = 0; }
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
         bool IsNULL() const { return mValue == NULL; }
 
-        const char *GetString() const { return mValue; }
+        const char *GetString() const
+        {
+            if (IsBinaryNumber())
+                FormatNumber();
+            return mValue;
+        }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (IsBinaryNumber())
+                return mType == DB_TYPE_FLOAT ? static_cast<float>(mNumber.f) : static_cast<float>(mNumber.i);
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atol(mValue)) : uint32(0); }
+        bool GetBool() const { return IsBinaryNumber() ? GetInt64() > 0 : (mValue ? atoi(mValue) > 0 : false); }
+        int32 GetInt32() const { return IsBinaryNumber() ? static_cast<int32>(GetInt64()) : (mValue ? static_cast<int32>(atol(mValue)) : int32(0)); }
+        uint8 GetUInt8() const { return IsBinaryNumber() ? static_cast<uint8>(GetInt64()) : (mValue ? static_cast<uint8>(atol(mValue)) : uint8(0)); }
+        uint16 GetUInt16() const { return IsBinaryNumber() ? static_cast<uint16>(GetInt64()) : (mValue ? static_cast<uint16>(atol(mValue)) : uint16(0)); }
+        int16 GetInt16() const { return IsBinaryNumber() ? static_cast<int16>(GetInt64()) : (mValue ? static_cast<int16>(atol(mValue)) : int16(0)); }
+        uint32 GetUInt32() const { return IsBinaryNumber() ? static_cast<uint32>(GetInt64()) : (mValue ? static_cast<uint32>(atol(mValue)) : uint32(0)); }
         uint64 GetUInt64() const
         {
+            if (IsBinaryNumber())
+                return static_cast<uint64>(GetInt64());
+
             uint64 value = 0;
             if(!mValue || sscanf(mValue,UI64FMTD,&value) == -1)
                 return 0;
@@ -67,13 +81,29 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         //no need for memory allocations to store resultset field strings
         //all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; };
+        void SetValue(const char* value) { mValue = value; mBinary = false; }
+
+        //binary results (prepared statements): numbers are stored as is, without any text
+        void SetInteger(int64 value) { mNumber.i = value; mValue = mText; mText[0] = 0; mBinary = true; }
+        void SetFloat(double value) { mNumber.f = value; mValue = mText; mText[0] = 0; mBinary = true; }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        bool IsBinaryNumber() const { return mBinary && mValue; }
+        int64 GetInt64() const { return mType == DB_TYPE_FLOAT ? static_cast<int64>(mNumber.f) : mNumber.i; }
+        //text of a binary number, only built if asked
+        void FormatNumber() const;
+
         const char* mValue;
         enum DataTypes mType;
+        bool mBinary;
+        union
+        {
+            int64 i;
+            double f;
+        } mNumber;
+        mutable char mText[32];
 };
 #endif
@@ -0,0 +1,68 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "DatabaseEnv.h"
+#include "QueryResultBinary.h"
+
+QueryResultBinary::QueryResultBinary(uint32 fieldCount) : QueryResult(0, fieldCount), mNextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+}
+
+QueryResultBinary::~QueryResultBinary()
+{
+    delete [] mCurrentRow;
+}
+
+void QueryResultBinary::AddRow()
+{
+    Slot empty;
+    empty.i = 0;
+    mSlots.resize(mSlots.size() + mFieldCount, empty);
+    mNulls.resize(mNulls.size() + mFieldCount, 0);
+    ++mRowCount;
+}
+
+void QueryResultBinary::SetString(uint32 index, const char* value, size_t length)
+{
+    CurrentSlot(index).offset = mStrings.size();
+    mStrings.insert(mStrings.end(), value, value + length);
+    mStrings.push_back('\0');
+}
+
+bool QueryResultBinary::NextRow()
+{
+    if (mNextRow >= mRowCount)
+        return false;
+
+    size_t first = size_t(mNextRow) * mFieldCount;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        Field& field = mCurrentRow[i];
+        Slot const& slot = mSlots[first + i];
+        if (mNulls[first + i])
+            field.SetValue(NULL);
+        else if (field.GetType() == Field::DB_TYPE_INTEGER)
+            field.SetInteger(slot.i);
+        else if (field.GetType() == Field::DB_TYPE_FLOAT)
+            field.SetFloat(slot.f);
+        else
+            field.SetValue(&mStrings[slot.offset]);
+    }
+
+    ++mNextRow;
+    return true;
+}
@@ -0,0 +1,60 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#if !defined(QUERYRESULTBINARY_H)
+#define QUERYRESULTBINARY_H
+
+#include "Common.h"
+#include "QueryResult.h"
+
+#include <vector>
+
+//rows of a prepared statement query, fetched in binary form
+//numbers are kept as such, strings are copied in a single buffer
+class QueryResultBinary : public QueryResult
+{
+    public:
+        explicit QueryResultBinary(uint32 fieldCount);
+
+        ~QueryResultBinary();
+
+        bool NextRow();
+
+        void SetFieldType(uint32 index, Field::DataTypes type) { mCurrentRow[index].SetType(type); }
+
+        //appends an empty row, the setters below fill it
+        void AddRow();
+        void SetNull(uint32 index) { mNulls[mNulls.size() - mFieldCount + index] = 1; }
+        void SetInteger(uint32 index, int64 value) { CurrentSlot(index).i = value; }
+        void SetFloat(uint32 index, double value) { CurrentSlot(index).f = value; }
+        void SetString(uint32 index, const char* value, size_t length);
+
+    private:
+        union Slot
+        {
+            int64 i;
+            double f;
+            size_t offset;                                  //in mStrings
+        };
+
+        Slot& CurrentSlot(uint32 index) { return mSlots[mSlots.size() - mFieldCount + index]; }
+
+        std::vector<Slot> mSlots;
+        std::vector<uint8> mNulls;
+        std::vector<char> mStrings;
+        uint64 mNextRow;
+};
+#endif
@@ -20,8 +20,10 @@
 #include "Database/SqlDelayThread.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
+#include <chrono>
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true),
+    m_queueSize(0), m_maxQueueSize(0), m_resetStats(false)
 {
 }
 
@@ -70,12 +72,36 @@ void SqlDelayThread::Stop()
     m_running = false;
 }
 
+bool SqlDelayThread::Delay(SqlOperation* sql)
+{
+    uint32 size = m_queueSize.fetch_add(1, std::memory_order_relaxed) + 1;
+    uint32 maxSize = m_maxQueueSize.load(std::memory_order_relaxed);
+    while (size > maxSize && !m_maxQueueSize.compare_exchange_weak(maxSize, size, std::memory_order_relaxed)) {}
+
+    m_sqlQueue.add(sql);
+    return true;
+}
+
 void SqlDelayThread::ProcessRequests()
 {
+    typedef std::chrono::steady_clock Clock;
+
+    if (m_resetStats.exchange(false, std::memory_order_relaxed))
+    {
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_latencyLock);
+            m_latencySnapshot.CopyFrom(m_latency);
+        }
+        m_latency.Reset();
+    }
+
     SqlOperation* s = NULL;
-    while (m_dbEngine->NextDelayedOperation(s))
+    while (m_sqlQueue.next(s))
     {
+        Clock::time_point start = Clock::now();
         s->Execute(m_dbConnection);
         delete s;
+        m_latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+        m_queueSize.fetch_sub(1, std::memory_order_relaxed);
     }
 }
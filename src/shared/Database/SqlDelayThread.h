@@ -23,6 +23,8 @@
 #include "ace/Thread_Mutex.h"
 #include "LockedQueue.h"
 #include "Threading.h"
+#include "LatencyHistogram.h"
+#include <atomic>
 
 
 class Database;
@@ -39,6 +41,13 @@ class SqlDelayThread : public ACE_Based::Runnable
         SqlConnection * m_dbConnection;                     ///< Pointer to DB connection
         volatile bool m_running;
 
+        std::atomic<uint32> m_queueSize;                    ///< Operations queued and not finished yet
+        std::atomic<uint32> m_maxQueueSize;                 ///< Highest m_queueSize since the last stats reset
+        std::atomic<bool> m_resetStats;
+        LatencyHistogram m_latency;                         ///< Execution time of the operations, recorded by this thread only
+        mutable ACE_Thread_Mutex m_latencyLock;
+        LatencyHistogram m_latencySnapshot;                 ///< m_latency as published at the last stats reset
+
         //process all enqueued requests
         void ProcessRequests();
 
@@ -47,7 +56,18 @@ class SqlDelayThread : public ACE_Based::Runnable
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql) { m_sqlQueue.add(sql); return true; }
+        bool Delay(SqlOperation* sql);
+
+        uint32 GetQueueSize() const { return m_queueSize.load(std::memory_order_relaxed); }
+        uint32 GetMaxQueueSize() const { return m_maxQueueSize.load(std::memory_order_relaxed); }
+        ///< Latencies of the operations between the two last stats resets
+        void GetLatency(LatencyHistogram& latency) const
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(m_latencyLock);
+            latency.CopyFrom(m_latencySnapshot);
+        }
+        ///< Latencies are published then reset by the worker itself, before its next operation
+        void ResetStats() { m_maxQueueSize.store(GetQueueSize(), std::memory_order_relaxed); m_resetStats.store(true, std::memory_order_relaxed); }
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
@@ -0,0 +1,50 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Database/SqlInsertBatch.h"
+#include "Database/DatabaseEnv.h"
+
+SqlInsertBatch::SqlInsertBatch(Database& db, char const* insert, char const* onDuplicate)
+    : m_db(db), m_insert(insert), m_onDuplicate(onDuplicate), m_rows(0)
+{
+}
+
+std::ostringstream& SqlInsertBatch::NewRow()
+{
+    if (m_rows >= MAX_ROWS || m_sql.tellp() > std::streampos(MAX_QUERY_LEN / 2))
+        Flush();
+
+    if (m_rows)
+        m_sql << "), (";
+    else
+        m_sql << m_insert << " VALUES (";
+    ++m_rows;
+    return m_sql;
+}
+
+void SqlInsertBatch::Flush()
+{
+    if (!m_rows)
+        return;
+
+    m_sql << ")";
+    if (m_onDuplicate)
+        m_sql << " " << m_onDuplicate;
+    m_db.Execute(m_sql.str().c_str());
+
+    m_sql.str(std::string());
+    m_rows = 0;
+}
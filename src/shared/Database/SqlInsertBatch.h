@@ -0,0 +1,56 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SQLINSERTBATCH_H
+#define MANGOS_SQLINSERTBATCH_H
+
+#include "Common.h"
+#include <sstream>
+#include <string>
+
+class Database;
+
+/**
+ * Builds multi-row "INSERT INTO table (columns) VALUES (...), (...) [ON DUPLICATE KEY UPDATE ...]"
+ * statements from rows streamed by the caller, so that saving N rows costs one
+ * statement instead of N.
+ * Statements go through Database::Execute and so join the transaction of the calling
+ * thread, if any. A statement is sent every MAX_ROWS rows and by Flush(), which
+ * must be called once all rows are added.
+ */
+class SqlInsertBatch
+{
+    public:
+        static const uint32 MAX_ROWS = 100;
+
+        // 'insert' is "INSERT INTO table (columns)", 'onDuplicate' the optional "ON DUPLICATE KEY UPDATE ..." clause
+        SqlInsertBatch(Database& db, char const* insert, char const* onDuplicate = NULL);
+
+        // Starts a new row and returns the stream to write its values to, separated by ", ".
+        // Beware of uint8 values, they must be cast to be written as numbers.
+        std::ostringstream& NewRow();
+        // Sends the pending rows
+        void Flush();
+
+    private:
+        Database& m_db;
+        char const* m_insert;
+        char const* m_onDuplicate;
+        std::ostringstream m_sql;
+        uint32 m_rows;
+};
+
+#endif
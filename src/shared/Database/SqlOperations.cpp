@@ -34,6 +34,32 @@ bool SqlPlainRequest::Execute(SqlConnection *conn)
     return conn->Execute(m_sql);
 }
 
+/// ---- OPERATIONS ON TWO KEYS ----
+
+bool SqlKeysBarrierWait::Execute(SqlConnection* /*conn*/)
+{
+    std::unique_lock<std::mutex> lock(m_barrier->lock);
+    m_barrier->otherReady = true;
+    m_barrier->cond.notify_all();
+    m_barrier->cond.wait(lock, [this]() { return m_barrier->done; });
+    return true;
+}
+
+bool SqlKeysBarrierOperation::Execute(SqlConnection* conn)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_barrier->lock);
+        m_barrier->cond.wait(lock, [this]() { return m_barrier->otherReady; });
+    }
+
+    bool result = m_op->Execute(conn);
+
+    std::lock_guard<std::mutex> guard(m_barrier->lock);
+    m_barrier->done = true;
+    m_barrier->cond.notify_all();
+    return result;
+}
+
 SqlTransaction::~SqlTransaction()
 {
     while(!m_queue.empty())
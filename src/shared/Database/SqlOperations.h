@@ -26,6 +26,9 @@
 #include "LockedQueue.h"
 #include <queue>
 #include "Utilities/Callback.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 
 /// ---- BASE ---
 
@@ -81,6 +84,43 @@ class SqlPreparedRequest : public SqlOperation
         SqlStmtParameters * m_param;
 };
 
+/// ---- OPERATIONS ON TWO KEYS ----
+
+// Meeting point of the two workers of an operation on two async keys (see SqlAsyncKey)
+struct SqlKeysBarrier
+{
+    SqlKeysBarrier() : otherReady(false), done(false) {}
+
+    std::mutex lock;
+    std::condition_variable cond;
+    bool otherReady;                                        // the other worker ran everything queued before
+    bool done;                                              // the operation ran
+};
+
+// Queued on the worker of the other key: holds it until the operation ran
+class SqlKeysBarrierWait : public SqlOperation
+{
+    public:
+        explicit SqlKeysBarrierWait(std::shared_ptr<SqlKeysBarrier> const& barrier) : m_barrier(barrier) {}
+        bool Execute(SqlConnection *conn);
+
+    private:
+        std::shared_ptr<SqlKeysBarrier> m_barrier;
+};
+
+// Queued on the worker of the key: runs the operation once the other worker waits
+class SqlKeysBarrierOperation : public SqlOperation
+{
+    public:
+        SqlKeysBarrierOperation(SqlOperation* op, std::shared_ptr<SqlKeysBarrier> const& barrier) : m_op(op), m_barrier(barrier) {}
+        ~SqlKeysBarrierOperation() { delete m_op; }
+        bool Execute(SqlConnection *conn);
+
+    private:
+        SqlOperation* m_op;
+        std::shared_ptr<SqlKeysBarrier> m_barrier;
+};
+
 /// ---- ASYNC QUERIES ----
 
 class SqlQuery;                                             /// contains a single async query
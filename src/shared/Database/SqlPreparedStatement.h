@@ -206,6 +206,23 @@ class MANGOS_DLL_SPEC SqlStatement
 
         bool Execute();
         bool DirectExecute();
+        //synchronous SELECT, results are fetched in binary form when the DBMS allows it
+        QueryResult* Query();
+
+        template<typename ParamType1>
+        QueryResult* PQuery(ParamType1 param1)
+        {
+            arg(param1);
+            return Query();
+        }
+
+        template<typename ParamType1, typename ParamType2>
+        QueryResult* PQuery(ParamType1 param1, ParamType2 param2)
+        {
+            arg(param1);
+            arg(param2);
+            return Query();
+        }
 
         //templates to simplify 1-4 parameter bindings
         template<typename ParamType1>
@@ -325,6 +342,8 @@ class MANGOS_DLL_SPEC SqlPreparedStatement
 
         //execute statement w/o result set
         virtual bool execute() = 0;
+        //execute a SELECT statement, NULL if there is no row
+        virtual QueryResult* query() = 0;
 
     protected:
         SqlPreparedStatement(const std::string& fmt, SqlConnection& conn) : m_szFmt(fmt), m_nParams(0), m_nColumns(0), m_bPrepared(false), m_bIsQuery(false), m_pConn(conn) {}
@@ -351,6 +370,7 @@ class MANGOS_DLL_SPEC SqlPlainPreparedStatement : public SqlPreparedStatement
         virtual void bind(const SqlStmtParameters& holder);
 
         virtual bool execute();
+        virtual QueryResult* query();
 
     protected:
         void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt);
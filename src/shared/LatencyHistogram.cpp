@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LatencyHistogram.h"
+
+void LatencyHistogram::Reset()
+{
+    for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::CopyFrom(LatencyHistogram const& other)
+{
+    for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+        m_buckets[i].store(other.m_buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_count.store(other.GetCount(), std::memory_order_relaxed);
+    m_total.store(other.m_total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_max.store(other.GetMax(), std::memory_order_relaxed);
+}
+
+uint32 LatencyHistogram::BucketIndex(uint64 value)
+{
+    if (value < 2 * SUB_BUCKETS)
+        return uint32(value);
+
+    uint32 msb = 0;
+    for (uint64 v = value; v > 1; v >>= 1)
+        ++msb;
+    // 'sub' is in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+    uint32 shift = msb - 4;
+    if (shift > MAX_SHIFT)
+        return BUCKET_COUNT - 1;
+    uint32 sub = uint32(value >> shift);
+    return shift * SUB_BUCKETS + sub;
+}
+
+uint64 LatencyHistogram::BucketHighestValue(uint32 index)
+{
+    if (index < 2 * SUB_BUCKETS)
+        return index;
+
+    uint32 shift = index / SUB_BUCKETS - 1;
+    uint64 sub = index % SUB_BUCKETS + SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+uint64 LatencyHistogram::GetMean() const
+{
+    uint64 count = GetCount();
+    return count ? m_total.load(std::memory_order_relaxed) / count : 0;
+}
+
+uint64 LatencyHistogram::GetPercentile(double percentile) const
+{
+    uint64 count = GetCount();
+    if (!count)
+        return 0;
+
+    uint64 wanted = uint64(percentile / 100.0 * count + 0.5);
+    if (wanted < 1)
+        wanted = 1;
+
+    uint64 seen = 0;
+    for (uint32 i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= wanted)
+            return std::min(BucketHighestValue(i), GetMax());
+    }
+    return GetMax();
+}
@@ -0,0 +1,76 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LATENCYHISTOGRAM_H
+#define MANGOS_LATENCYHISTOGRAM_H
+
+#include "Common.h"
+#include <atomic>
+
+/**
+ * Log-linear (HDR style) histogram of durations in microseconds.
+ *
+ * Values below 32 are exact, then each power of two is split in 16 buckets,
+ * so any percentile is known within 1/16 of its value, from 1us to ~38 hours,
+ * with a fixed 2KB footprint and an O(1) Record().
+ * A single thread records, any thread may read: counters are relaxed atomics
+ * written without read-modify-write, reads are only a snapshot.
+ */
+class LatencyHistogram
+{
+    public:
+        static const uint32 SUB_BUCKETS = 16;
+        static const uint32 MAX_SHIFT = 32;
+        static const uint32 BUCKET_COUNT = (MAX_SHIFT + 1) * SUB_BUCKETS + SUB_BUCKETS;
+
+        LatencyHistogram() { Reset(); }
+
+        void Record(uint64 value)
+        {
+            Increment(m_buckets[BucketIndex(value)], 1);
+            Increment(m_count, 1);
+            Increment(m_total, value);
+            if (value > m_max.load(std::memory_order_relaxed))
+                m_max.store(value, std::memory_order_relaxed);
+        }
+
+        void Reset();
+        // Copies the counters of a histogram no thread is recording in
+        void CopyFrom(LatencyHistogram const& other);
+
+        uint64 GetCount() const { return m_count.load(std::memory_order_relaxed); }
+        uint64 GetMax() const { return m_max.load(std::memory_order_relaxed); }
+        uint64 GetMean() const;
+        // Highest value of the bucket holding the given percentile (0-100)
+        uint64 GetPercentile(double percentile) const;
+
+        static uint32 BucketIndex(uint64 value);
+        static uint64 BucketHighestValue(uint32 index);
+
+    private:
+        template<class T>
+        static void Increment(std::atomic<T>& counter, uint64 value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + T(value), std::memory_order_relaxed);
+        }
+
+        std::atomic<uint32> m_buckets[BUCKET_COUNT];
+        std::atomic<uint64> m_count;
+        std::atomic<uint64> m_total;
+        std::atomic<uint64> m_max;
+};
+
+#endif
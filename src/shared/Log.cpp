@@ -309,6 +309,7 @@ void Log::Initialize()
     logFiles[LOG_GM_CRITICAL]   = openLogFile("CriticalCommandsLogFile", nullptr, "a");
     logFiles[LOG_CHAT_SPAM]     = openLogFile("ChatSpamLogFile", nullptr, "a");
     logFiles[LOG_EXPLOITS]      = openLogFile("ExploitsLogFile", nullptr, "a");
+    logFiles[LOG_PROFILER]      = openLogFile("PerformanceLog.ProfileFile", nullptr, "a");
 
     timestampPrefix[LOG_DBERRFIX] = false;
 
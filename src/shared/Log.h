@@ -101,6 +101,7 @@ enum LogFile
     LOG_GM_CRITICAL,
     LOG_CHAT_SPAM,
     LOG_EXPLOITS,
+    LOG_PROFILER,
     LOG_MAX_FILES
 };
 
@@ -0,0 +1,127 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PacketSlab.h"
+#include <new>
+
+namespace
+{
+    thread_local PacketSlab* t_slab = nullptr;
+}
+
+void PacketSlab::InitThread()
+{
+    if (!t_slab)
+        t_slab = new PacketSlab();
+}
+
+void PacketSlab::ReleaseThread()
+{
+    PacketSlab* slab = t_slab;
+    if (!slab)
+        return;
+
+    t_slab = nullptr;
+    while (Block* block = slab->m_freeList)
+    {
+        slab->m_freeList = block->next;
+        delete block;
+    }
+    slab->Unref();
+}
+
+PacketSlab::Block* PacketSlab::FromData(void* ptr)
+{
+    return reinterpret_cast<Block*>(static_cast<char*>(ptr) - offsetof(Block, data));
+}
+
+void* PacketSlab::Allocate(size_t size)
+{
+    PacketSlab* slab = t_slab;
+    if (!slab || size > BLOCK_SIZE)
+    {
+        Block* block = static_cast<Block*>(::operator new(offsetof(Block, data) + size));
+        block->owner = nullptr;
+        return block->data;
+    }
+
+    Block* block = slab->Pop();
+    if (!block)
+    {
+        block = new Block;
+        block->owner = slab;
+    }
+    slab->m_refs.fetch_add(1, std::memory_order_relaxed);
+    return block->data;
+}
+
+void PacketSlab::Free(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    Block* block = FromData(ptr);
+    PacketSlab* slab = block->owner;
+    if (!slab)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    if (slab == t_slab)
+    {
+        block->next = slab->m_freeList;
+        slab->m_freeList = block;
+    }
+    else
+        slab->PushRemote(block);
+    slab->Unref();
+}
+
+PacketSlab::Block* PacketSlab::Pop()
+{
+    if (!m_freeList)
+        m_freeList = m_remoteFree.exchange(nullptr, std::memory_order_acquire);
+
+    Block* block = m_freeList;
+    if (block)
+        m_freeList = block->next;
+    return block;
+}
+
+void PacketSlab::PushRemote(Block* block)
+{
+    Block* head = m_remoteFree.load(std::memory_order_relaxed);
+    do
+        block->next = head;
+    while (!m_remoteFree.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void PacketSlab::Unref()
+{
+    if (m_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    // Thread gone and every block back: nobody can reach this slab anymore
+    Block* block = m_remoteFree.exchange(nullptr, std::memory_order_acquire);
+    while (block)
+    {
+        Block* next = block->next;
+        delete block;
+        block = next;
+    }
+    delete this;
+}
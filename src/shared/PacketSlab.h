@@ -0,0 +1,72 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PACKETSLAB_H
+#define MANGOS_PACKETSLAB_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Free list of fixed size blocks for the WorldPacket objects created by a network thread.
+ *
+ * Received packets are allocated by a network thread and deleted by the map or world
+ * threads. The owning thread allocates and frees without any synchronization, other
+ * threads give the blocks back with a single CAS on a lock-free stack, taken back
+ * as a whole by the owner when its own free list is empty.
+ *
+ * Every block starts with a header pointing to its slab, so Free() works for any
+ * block, and for packets allocated by threads without a slab (plain operator new).
+ * The slab is destroyed once its thread released it and all its blocks came back.
+ */
+class PacketSlab
+{
+    public:
+        // Biggest object served from the slab, bigger ones use operator new
+        static const size_t BLOCK_SIZE = 64;
+
+        // Creates the slab of the calling thread
+        static void InitThread();
+        // Detaches the slab of the calling thread, it is destroyed when its last block is freed
+        static void ReleaseThread();
+
+        static void* Allocate(size_t size);
+        static void Free(void* ptr);
+
+    private:
+        struct Block
+        {
+            PacketSlab* owner;
+            Block* next;
+            // keeps the object aligned as with operator new
+            alignas(16) char data[BLOCK_SIZE];
+        };
+
+        PacketSlab() : m_freeList(nullptr), m_remoteFree(nullptr), m_refs(1) {}
+
+        Block* Pop();
+        void PushRemote(Block* block);
+        // Drops one reference, deletes the slab when it was the last one
+        void Unref();
+
+        static Block* FromData(void* ptr);
+
+        Block* m_freeList;                                  // owning thread only
+        std::atomic<Block*> m_remoteFree;                   // blocks freed by other threads
+        std::atomic<size_t> m_refs;                         // blocks in use + 1 for the owning thread
+};
+
+#endif
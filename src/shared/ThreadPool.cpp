@@ -0,0 +1,301 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ThreadPool.h"
+#include <chrono>
+
+#ifdef WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    thread_local ThreadPool* t_currentPool = nullptr;
+    thread_local int t_currentWorker = -1;
+}
+
+void ThreadPool::TaskGroup::Run(Task task)
+{
+    ++m_pending;
+    m_pool.PushShort(new Job(std::move(task), this));
+}
+
+void ThreadPool::TaskGroup::RunLong(Task task)
+{
+    ++m_pending;
+    m_pool.PushLong(new Job(std::move(task), this));
+}
+
+void ThreadPool::TaskGroup::Wait()
+{
+    uint32_t idleLoops = 0;
+    while (m_pending)
+    {
+        if (m_pool.HelpOnce())
+        {
+            idleLoops = 0;
+            continue;
+        }
+        // Nothing to steal: the remaining tasks are running elsewhere
+        if (++idleLoops < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+ThreadPool::ThreadPool() : m_workerCount(0), m_queuedJobs(0), m_stop(false), m_pinToCores(false)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+void ThreadPool::Start(std::size_t threads, bool pinToCores, ThreadHook onThreadStart, ThreadHook onThreadStop)
+{
+    if (IsStarted())
+        return;
+
+    if (!threads)
+        threads = std::thread::hardware_concurrency();
+    if (!threads)
+        threads = 1;
+
+    m_stop = false;
+    m_pinToCores = pinToCores;
+    m_onThreadStart = onThreadStart;
+    m_onThreadStop = onThreadStop;
+    Reserve(threads);
+}
+
+void ThreadPool::Reserve(std::size_t threads)
+{
+    if (threads > MAX_WORKERS)
+        threads = MAX_WORKERS;
+
+    for (std::size_t i = m_workerCount; i < threads; ++i)
+        SpawnWorker(i);
+}
+
+void ThreadPool::Stop()
+{
+    if (!IsStarted())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+
+    std::size_t count = m_workerCount;
+    for (std::size_t i = 0; i < count; ++i)
+        if (m_workers[i].thread.joinable())
+            m_workers[i].thread.join();
+
+    // Workers are gone: run what is left so that no TaskGroup waits forever.
+    // Their deques are still visible to PopShort until m_workerCount is reset.
+    for (;;)
+    {
+        Job* job = PopShort(-1);
+        if (!job)
+            job = PopLong();
+        if (!job)
+            break;
+        Execute(job);
+    }
+    m_workerCount = 0;
+}
+
+int ThreadPool::GetCurrentWorkerIndex()
+{
+    return t_currentWorker;
+}
+
+void ThreadPool::SpawnWorker(std::size_t index)
+{
+    m_workers[index].thread = std::thread(&ThreadPool::WorkerMain, this, index);
+    if (m_pinToCores)
+        PinToCore(m_workers[index].thread, index);
+    // Publish only once the worker slot is ready to be stolen from
+    m_workerCount = index + 1;
+}
+
+void ThreadPool::PinToCore(std::thread& thread, std::size_t index)
+{
+    std::size_t cores = std::thread::hardware_concurrency();
+    if (!cores)
+        return;
+    std::size_t core = index % cores;
+#ifdef WIN32
+    SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << core);
+#elif defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+void ThreadPool::WorkerMain(std::size_t index)
+{
+    t_currentPool = this;
+    t_currentWorker = int(index);
+
+    if (m_onThreadStart)
+        m_onThreadStart();
+
+    while (!m_stop)
+    {
+        Job* job = PopShort(int(index));
+        if (!job)
+            job = PopLong();
+        if (job)
+        {
+            Execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_wakeUp.wait_for(lock, std::chrono::milliseconds(1), [this]() { return m_stop || m_queuedJobs != 0; });
+    }
+
+    if (m_onThreadStop)
+        m_onThreadStop();
+
+    t_currentPool = nullptr;
+    t_currentWorker = -1;
+}
+
+void ThreadPool::PushShort(Job* job)
+{
+    ++m_queuedJobs;
+    if (t_currentPool == this && t_currentWorker >= 0)
+    {
+        Worker& self = m_workers[t_currentWorker];
+        std::lock_guard<std::mutex> guard(self.lock);
+        self.jobs.push_back(job);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guard(m_sharedLock);
+        m_sharedJobs.push_back(job);
+    }
+    WakeUp();
+}
+
+void ThreadPool::PushLong(Job* job)
+{
+    ++m_queuedJobs;
+    {
+        std::lock_guard<std::mutex> guard(m_longLock);
+        m_longJobs.push_back(job);
+    }
+    WakeUp();
+}
+
+ThreadPool::Job* ThreadPool::PopShort(int selfIndex)
+{
+    Job* job = nullptr;
+
+    // Own deque first, newest task (still hot in cache)
+    if (selfIndex >= 0)
+    {
+        Worker& self = m_workers[selfIndex];
+        std::lock_guard<std::mutex> guard(self.lock);
+        if (!self.jobs.empty())
+        {
+            job = self.jobs.back();
+            self.jobs.pop_back();
+        }
+    }
+
+    if (!job)
+    {
+        std::lock_guard<std::mutex> guard(m_sharedLock);
+        if (!m_sharedJobs.empty())
+        {
+            job = m_sharedJobs.front();
+            m_sharedJobs.pop_front();
+        }
+    }
+
+    // Steal the oldest task of another worker
+    std::size_t count = m_workerCount;
+    for (std::size_t i = 1; !job && i <= count; ++i)
+    {
+        std::size_t victim = (std::size_t(selfIndex + 1) + i) % count;
+        if (int(victim) == selfIndex)
+            continue;
+        Worker& other = m_workers[victim];
+        std::unique_lock<std::mutex> guard(other.lock, std::try_to_lock);
+        if (guard.owns_lock() && !other.jobs.empty())
+        {
+            job = other.jobs.front();
+            other.jobs.pop_front();
+        }
+    }
+
+    if (job)
+        --m_queuedJobs;
+    return job;
+}
+
+ThreadPool::Job* ThreadPool::PopLong()
+{
+    std::lock_guard<std::mutex> guard(m_longLock);
+    if (m_longJobs.empty())
+        return nullptr;
+    Job* job = m_longJobs.front();
+    m_longJobs.pop_front();
+    --m_queuedJobs;
+    return job;
+}
+
+void ThreadPool::Execute(Job* job)
+{
+    job->task();
+    TaskGroup* group = job->group;
+    delete job;
+    if (group)
+        --group->m_pending;
+}
+
+void ThreadPool::WakeUp()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_sleepLock);
+    }
+    m_wakeUp.notify_one();
+}
+
+bool ThreadPool::HelpOnce()
+{
+    int self = t_currentPool == this ? t_currentWorker : -1;
+    Job* job = PopShort(self);
+    if (!job)
+        return false;
+    Execute(job);
+    return true;
+}
@@ -0,0 +1,144 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_THREADPOOL_H
+#define MANGOS_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Persistent work-stealing pool used by the map update code.
+ *
+ * Threads are created once and live until Stop(). Work comes in two kinds:
+ *  - short tasks (TaskGroup::Run) go to the calling worker's own deque. Other
+ *    workers steal from the front while the owner pops from the back, and any
+ *    thread blocked in TaskGroup::Wait() helps running them.
+ *  - long tasks (TaskGroup::RunLong) may block or loop (a whole map update for
+ *    example). They are only picked up by idle workers, never by a helping
+ *    Wait(), so a waiting task can not end up waiting on itself.
+ */
+class ThreadPool
+{
+    public:
+        typedef std::function<void()> Task;
+        typedef std::function<void()> ThreadHook;
+
+        class TaskGroup
+        {
+            public:
+                explicit TaskGroup(ThreadPool& pool) : m_pool(pool), m_pending(0) {}
+                ~TaskGroup() { Wait(); }
+
+                // Fork a short, non blocking task
+                void Run(Task task);
+                // Fork a task that may block until other tasks are done
+                void RunLong(Task task);
+                // Join: returns once every task of this group is done. Runs pending short tasks meanwhile.
+                void Wait();
+
+                std::size_t GetPendingCount() const { return m_pending; }
+
+            private:
+                TaskGroup(TaskGroup const&);
+                TaskGroup& operator=(TaskGroup const&);
+
+                friend class ThreadPool;
+
+                ThreadPool& m_pool;
+                std::atomic<std::size_t> m_pending;
+        };
+
+        ThreadPool();
+        ~ThreadPool();
+
+        /**
+         * Spawns the workers. 'threads' = 0 uses the number of hardware threads.
+         * 'onThreadStart' / 'onThreadStop' are called once in each worker (database thread init ...)
+         */
+        void Start(std::size_t threads, bool pinToCores, ThreadHook onThreadStart = ThreadHook(), ThreadHook onThreadStop = ThreadHook());
+        void Stop();
+
+        // Make sure at least 'threads' workers are running. Must be called from the thread owning the pool.
+        void Reserve(std::size_t threads);
+
+        std::size_t GetThreadCount() const { return m_workerCount; }
+        bool IsStarted() const { return m_workerCount != 0; }
+
+        // Index of the calling worker in its pool, -1 if the caller is not a pool thread
+        static int GetCurrentWorkerIndex();
+
+        static const std::size_t MAX_WORKERS = 64;
+
+    private:
+        ThreadPool(ThreadPool const&);
+        ThreadPool& operator=(ThreadPool const&);
+
+        struct Job
+        {
+            Job(Task&& t, TaskGroup* g) : task(std::move(t)), group(g) {}
+            Task task;
+            TaskGroup* group;
+        };
+
+        struct Worker
+        {
+            std::mutex lock;
+            std::deque<Job*> jobs;
+            std::thread thread;
+        };
+
+        void SpawnWorker(std::size_t index);
+        void WorkerMain(std::size_t index);
+        void PinToCore(std::thread& thread, std::size_t index);
+
+        void PushShort(Job* job);
+        void PushLong(Job* job);
+        Job* PopShort(int selfIndex);
+        Job* PopLong();
+        void Execute(Job* job);
+        void WakeUp();
+
+        // Run a single pending short task if any. Used by TaskGroup::Wait()
+        bool HelpOnce();
+
+        Worker m_workers[MAX_WORKERS];
+        std::atomic<std::size_t> m_workerCount;
+
+        // Short tasks forked from threads not belonging to the pool
+        std::mutex m_sharedLock;
+        std::deque<Job*> m_sharedJobs;
+
+        std::mutex m_longLock;
+        std::deque<Job*> m_longJobs;
+
+        std::mutex m_sleepLock;
+        std::condition_variable m_wakeUp;
+        std::atomic<std::size_t> m_queuedJobs;
+
+        std::atomic<bool> m_stop;
+        bool m_pinToCores;
+        ThreadHook m_onThreadStart;
+        ThreadHook m_onThreadStop;
+};
+
+#endif
@@ -22,6 +22,8 @@
 
 #include "Common.h"
 #include "ByteBuffer.h"
+#include "PacketSlab.h"
+#include <new>
 
 // Note: m_opcode and size stored in platfom dependent format
 // ignore endianess until send, and converted at receive
@@ -29,16 +31,16 @@ class WorldPacket : public ByteBuffer
 {
     public:
                                                             // just container for later use
-        WorldPacket()                                       : ByteBuffer(0), m_opcode(0), m_recvdTime(0)
+        WorldPacket()                                       : ByteBuffer(0), m_opcode(0), m_recvdTime(0), m_compressionPending(false)
         {
         }
-        explicit WorldPacket(uint16 opcode, size_t res=200) : ByteBuffer(res), m_opcode(opcode), m_recvdTime(0) { }
+        explicit WorldPacket(uint16 opcode, size_t res=200) : ByteBuffer(res), m_opcode(opcode), m_recvdTime(0), m_compressionPending(false) { }
                                                             // copy constructor
-        WorldPacket(const WorldPacket &packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode), m_recvdTime(0)
+        WorldPacket(const WorldPacket &packet)              : ByteBuffer(packet), m_opcode(packet.m_opcode), m_recvdTime(0), m_compressionPending(packet.m_compressionPending)
         {
         }
 
-        WorldPacket(WorldPacket &&packet) : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), m_recvdTime(packet.m_recvdTime)
+        WorldPacket(WorldPacket &&packet) : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode), m_recvdTime(packet.m_recvdTime), m_compressionPending(packet.m_compressionPending)
         {
         }
 
@@ -46,6 +48,7 @@ class WorldPacket : public ByteBuffer
         {
             m_opcode = rhs.m_opcode;
             m_recvdTime = rhs.m_recvdTime;
+            m_compressionPending = rhs.m_compressionPending;
             ByteBuffer::operator=(std::move(rhs));
             return *this;
         }
@@ -55,6 +58,7 @@ class WorldPacket : public ByteBuffer
             clear();
             _storage.reserve(newres);
             m_opcode = opcode;
+            m_compressionPending = false;
         }
 
         uint16 GetOpcode() const { return m_opcode; }
@@ -63,8 +67,19 @@ class WorldPacket : public ByteBuffer
         uint32 GetPacketTime() const { return m_recvdTime; }
         void FillPacketTime(uint32 t) { m_recvdTime = t; }
 
+        // Compressed opcode whose payload is still uncompressed: compression is done by the network thread
+        bool IsCompressionPending() const { return m_compressionPending; }
+        void SetCompressionPending(bool pending) { m_compressionPending = pending; }
+
+        // Packets allocated by network threads come from their PacketSlab
+        static void* operator new(size_t size) { return PacketSlab::Allocate(size); }
+        static void* operator new(size_t size, std::nothrow_t const&) noexcept { return PacketSlab::Allocate(size); }
+        static void operator delete(void* ptr) { PacketSlab::Free(ptr); }
+        static void operator delete(void* ptr, std::nothrow_t const&) noexcept { PacketSlab::Free(ptr); }
+
     protected:
         uint16 m_opcode;
         uint32 m_recvdTime;
+        bool m_compressionPending;
 };
 #endif